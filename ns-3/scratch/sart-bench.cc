@@ -0,0 +1,872 @@
+/*
+ * This work is licensed under CC BY-NC-SA 4.0
+ * (https://creativecommons.org/licenses/by-nc-sa/4.0/).
+ * Copyright (c) 2025 Boyang Zhou
+ *
+ * This file is a part of "Subpath-Aware Reliable Transport Control Protocol (SART) for Wireless Multihop Networks"
+ * (https://github.com/zhouby-zjl/sart/).
+ * Written by Boyang Zhou (zhouby@zhejianglab.com / zby_zju@163.com)
+ *
+ * Micro-benchmarks of the SART data structures, run by:
+ * ./waf --run "scratch/sart-bench --iterations=10000"
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/ndnSIM/NFD/daemon/fw/rntp-strategy.hpp"
+#include "ns3/ndnSIM/model/rntp-coding.hpp"
+#include "ns3/ndnSIM/model/rntp-config.hpp"
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <list>
+#include <random>
+#include <vector>
+
+using namespace std;
+using namespace ns3;
+using namespace ::nfd::fw;
+
+static size_t bench_bytesAllocated = 0;
+
+// counts the heap bytes taken by the list nodes of the per-hop route layout
+template <class T>
+struct CountingAllocator {
+	typedef T value_type;
+	CountingAllocator() {}
+	template <class U> CountingAllocator(const CountingAllocator<U>&) {}
+	T* allocate(size_t n) {
+		bench_bytesAllocated += n * sizeof(T);
+		return static_cast<T*>(::operator new(n * sizeof(T)));
+	}
+	void deallocate(T* p, size_t n) {
+		bench_bytesAllocated -= n * sizeof(T);
+		::operator delete(p);
+	}
+	template <class U> bool operator==(const CountingAllocator<U>&) const { return true; }
+	template <class U> bool operator!=(const CountingAllocator<U>&) const { return false; }
+};
+
+struct ListRoute {
+	list<uint32_t, CountingAllocator<uint32_t> > 	nodeIDs;
+	list<double, CountingAllocator<double> > 		channelQualities;
+	double 											metric;
+};
+
+double getElapsedNanoSecs(chrono::steady_clock::time_point start) {
+	return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+}
+
+void benchRouteStore(uint32_t nPairs, uint32_t nRoutesPerPair, uint32_t nHops, uint32_t iterations) {
+	Ptr<UniformRandomVariable> rand = CreateObject<UniformRandomVariable>();
+	uint32_t nRoutes = nPairs * nRoutesPerPair;
+
+	vector<vector<ListRoute*> > pairs_list(nPairs);
+	vector<RouteStore> pairs_store(nPairs);
+	bench_bytesAllocated = 0;
+	for (uint32_t p = 0; p < nPairs; ++p) {
+		for (uint32_t r = 0; r < nRoutesPerPair; ++r) {
+			ListRoute* route = new ListRoute;
+			list<uint32_t> nodeIDs;
+			for (uint32_t i = 0; i <= nHops; ++i) {
+				uint32_t nodeID = rand->GetInteger(0, 1000);
+				route->nodeIDs.push_back(nodeID);
+				nodeIDs.push_back(nodeID);
+			}
+			uint32_t slot = pairs_store[p].addRoute(nodeIDs);
+			for (uint32_t i = 0; i < nHops; ++i) {
+				double quality = rand->GetValue(0.01, 1.0);
+				route->channelQualities.push_back(quality);
+				pairs_store[p].setLinkQuality(slot, i, quality);
+			}
+			pairs_list[p].push_back(route);
+		}
+	}
+	size_t bytes_list = bench_bytesAllocated + nRoutes * sizeof(ListRoute) + nPairs * nRoutesPerPair * sizeof(ListRoute*);
+	size_t bytes_store = 0;
+	for (uint32_t p = 0; p < nPairs; ++p) {
+		bytes_store += pairs_store[p].getMemoryUsage();
+	}
+
+	double checksum_list = 0.0;
+	auto start = chrono::steady_clock::now();
+	for (uint32_t it = 0; it < iterations; ++it) {
+		for (uint32_t p = 0; p < nPairs; ++p) {
+			for (ListRoute* route : pairs_list[p]) {
+				double logQualitySum = 0.0;
+				for (double quality : route->channelQualities) {
+					logQualitySum += log(quality);
+				}
+				route->metric = exp(logQualitySum / (2 * route->channelQualities.size()));
+				checksum_list += route->metric;
+			}
+		}
+	}
+	double ns_list = getElapsedNanoSecs(start) / ((double) iterations * nRoutes);
+
+	double checksum_store = 0.0;
+	start = chrono::steady_clock::now();
+	for (uint32_t it = 0; it < iterations; ++it) {
+		for (uint32_t p = 0; p < nPairs; ++p) {
+			pairs_store[p].computeMetrics(0.0);
+			for (uint32_t r = 0; r < nRoutesPerPair; ++r) {
+				checksum_store += pairs_store[p].getMetric(r);
+			}
+		}
+	}
+	double ns_store = getElapsedNanoSecs(start) / ((double) iterations * nRoutes);
+
+	// a route scored before it is stored, as when deciding whether to keep it, must rank the same
+	uint32_t nMismatches = 0;
+	for (uint32_t p = 0; p < nPairs; ++p) {
+		for (uint32_t r = 0; r < nRoutesPerPair; ++r) {
+			list<double> qualities(pairs_list[p][r]->channelQualities.begin(), pairs_list[p][r]->channelQualities.end());
+			if ((double) RouteStore::computeMetric(qualities, 0.0) != pairs_store[p].getMetric(r)) {
+				++nMismatches;
+			}
+		}
+	}
+
+	cout << "route store: " << nPairs << " pairs, " << nRoutesPerPair << " routes per pair, " << nHops << " hops" << endl;
+	cout << "  per-hop lists:     " << (double) bytes_list / nRoutes << " bytes/route, " << ns_list << " ns/metric"
+			<< " (checksum " << checksum_list / iterations << ")" << endl;
+	cout << "  structure-of-arrays: " << (double) bytes_store / nRoutes << " bytes/route, " << ns_store << " ns/metric"
+			<< " (checksum " << checksum_store / iterations << ")" << endl;
+	cout << "  metrics of unstored routes differing from the store: " << nMismatches << endl;
+
+	for (uint32_t p = 0; p < nPairs; ++p) {
+		for (ListRoute* route : pairs_list[p]) {
+			delete route;
+		}
+	}
+}
+
+// the list-based CapsuleQueue replaced by the indexed one, kept for comparison
+class ListCapsuleQueue {
+public:
+	ListCapsuleQueue() : nHiddenElements(0) {}
+
+	void removeElement(uint32_t dataID) {
+		for (auto iter = buffer.begin(); iter != buffer.end();) {
+			if (iter->capInfo.dataID == dataID) {
+				if (iter->hidden) --nHiddenElements;
+				iter = buffer.erase(iter);
+			} else {
+				++iter;
+			}
+		}
+	}
+	void pushElement(CapsuleToSend& element) {
+		element.hidden = false;
+		buffer.push_back(element);
+	}
+	void transientlyPopElement() {
+		for (auto iter = buffer.begin(); iter != buffer.end(); ++iter) {
+			if (!iter->hidden) {
+				iter->hidden = true;
+				++nHiddenElements;
+				return;
+			}
+		}
+	}
+	CapsuleToSend* getFront() {
+		for (auto iter = buffer.begin(); iter != buffer.end(); ++iter) {
+			if (!iter->hidden) return &(*iter);
+		}
+		return NULL;
+	}
+	CapsuleToSend* restoreElement(uint32_t dataID) {
+		for (auto iter = buffer.begin(); iter != buffer.end(); ++iter) {
+			if (iter->capInfo.dataID == dataID) {
+				if (iter->hidden) {
+					iter->hidden = false;
+					--nHiddenElements;
+				}
+				return &(*iter);
+			}
+		}
+		return NULL;
+	}
+	size_t countElements() {
+		return buffer.size() - nHiddenElements;
+	}
+
+private:
+	std::list<CapsuleToSend> buffer;
+	uint32_t nHiddenElements;
+};
+
+// a relay with a backlog: sends a window of capsules, then acknowledges them in random
+// order, with a share of them timing out and being restored instead
+template <class Queue>
+double runCapsuleQueue(Queue& queue, uint32_t window, uint32_t backlog, uint32_t rounds, double lossRatio, uint64_t* checksum) {
+	Ptr<UniformRandomVariable> rand = CreateObject<UniformRandomVariable>();
+	rand->SetStream(1);
+	CapsuleToSend cts;
+	cts.nTimesRetried = 0;
+	cts.code = SEND_CAP_FROM_PERVIOUS_HOP;
+	uint32_t dataID_next = 0;
+	for (; dataID_next < backlog; ++dataID_next) {
+		cts.capInfo.dataID = dataID_next;
+		queue.pushElement(cts);
+	}
+
+	uint64_t nOps = 0;
+	vector<uint32_t> inflight;
+	auto start = chrono::steady_clock::now();
+	for (uint32_t round = 0; round < rounds; ++round) {
+		for (uint32_t i = 0; i < window && queue.countElements() > 0; ++i) {
+			inflight.push_back(queue.getFront()->capInfo.dataID);
+			queue.transientlyPopElement();
+			nOps += 2;
+		}
+		for (uint32_t i = inflight.size(); i > 1; --i) {
+			std::swap(inflight[i - 1], inflight[rand->GetInteger(0, i - 1)]);
+		}
+		for (uint32_t dataID : inflight) {
+			if (rand->GetValue() < lossRatio) {
+				*checksum += queue.restoreElement(dataID)->capInfo.dataID;
+			} else {
+				queue.removeElement(dataID);
+				cts.capInfo.dataID = dataID_next++;
+				queue.pushElement(cts);
+				++nOps;
+			}
+			++nOps;
+		}
+		inflight.clear();
+	}
+	return getElapsedNanoSecs(start) / nOps;
+}
+
+void benchCapsuleQueue(uint32_t window, uint32_t backlog, uint32_t rounds) {
+	CapsuleQueue::enableLog = false;
+	uint64_t checksum_list = 0, checksum_indexed = 0;
+	ListCapsuleQueue queue_list;
+	double ns_list = runCapsuleQueue(queue_list, window, backlog, rounds, 0.1, &checksum_list);
+	CapsuleQueue queue_indexed;
+	double ns_indexed = runCapsuleQueue(queue_indexed, window, backlog, rounds, 0.1, &checksum_indexed);
+
+	cout << "capsule queue: window " << window << ", backlog " << backlog << ", " << rounds << " rounds" << endl;
+	cout << "  list:    " << ns_list << " ns/op (checksum " << checksum_list << ")" << endl;
+	cout << "  indexed: " << ns_indexed << " ns/op (checksum " << checksum_indexed << ")" << endl;
+}
+
+// The cost of a per-capsule state taken from the heap or from the pool, in a synthetic allocation
+// loop: a window of them is live at any time, and the oldest is freed for every new one, as when
+// capsules are acknowledged in order. Whether memory stays flat over a long run is for sart-sim to
+// show, with MEMORY_SAMPLE_PERIOD_IN_SECS set.
+void benchSendCapStatePool(uint32_t window, uint32_t nCapsules) {
+	cout << "send cap states: window " << window << ", " << nCapsules << " capsules" << endl;
+
+	vector<SendCapState*> live(window, NULL);
+	auto start = chrono::steady_clock::now();
+	for (uint32_t i = 0; i < nCapsules; ++i) {
+		delete live[i % window];
+		live[i % window] = new SendCapState();
+		live[i % window]->nodeIDs_down.insert(i);
+	}
+	double ns_heap = getElapsedNanoSecs(start) / nCapsules;
+	for (SendCapState* state : live) {
+		delete state;
+	}
+	cout << "  heap:   " << ns_heap << " ns/capsule" << endl;
+
+	ObjectPool<SendCapState> pool;
+	fill(live.begin(), live.end(), (SendCapState*) NULL);
+	start = chrono::steady_clock::now();
+	for (uint32_t i = 0; i < nCapsules; ++i) {
+		if (live[i % window] != NULL) {
+			pool.release(live[i % window]);
+		}
+		live[i % window] = pool.acquire();
+		live[i % window]->nodeIDs_down.insert(i);
+	}
+	double ns_pool = getElapsedNanoSecs(start) / nCapsules;
+	cout << "  pooled: " << ns_pool << " ns/capsule, " << pool.getMemoryUsage() / 1024 << " KiB in " <<
+			pool.countHighWater() << " states" << endl;
+	for (SendCapState* state : live) {
+		if (state != NULL) {
+			pool.release(state);
+		}
+	}
+}
+
+// encodes a generation's repairs and decodes it with a third of the sources lost
+void benchCoding(uint32_t k, uint32_t nGenerations) {
+	const size_t symbolSize = 1024;
+	cout << "coding: generation " << k << ", " << nGenerations << " generations, kernel " << Gf256::getKernelName() << endl;
+
+	vector<uint8_t> src(symbolSize), dst(symbolSize);
+	for (size_t i = 0; i < symbolSize; ++i) {
+		src[i] = i * 131;
+	}
+	uint32_t nOps = nGenerations * k;
+	auto start = chrono::steady_clock::now();
+	for (uint32_t i = 0; i < nOps; ++i) {
+		Gf256::mulAddScalar(dst.data(), src.data(), (i % 255) + 1, symbolSize);
+	}
+	double ns_scalar = getElapsedNanoSecs(start) / nOps;
+	start = chrono::steady_clock::now();
+	for (uint32_t i = 0; i < nOps; ++i) {
+		Gf256::mulAdd(dst.data(), src.data(), (i % 255) + 1, symbolSize);
+	}
+	double ns_simd = getElapsedNanoSecs(start) / nOps;
+	cout << "  mul-add of 1 KiB: scalar " << ns_scalar << " ns, vectorised " << ns_simd << " ns" << endl;
+
+	vector<vector<uint8_t> > sources(k, vector<uint8_t>(symbolSize));
+	vector<uint8_t> coefs(k), payload(symbolSize);
+	uint32_t nDecoded = 0;
+	start = chrono::steady_clock::now();
+	for (uint32_t g = 0; g < nGenerations; ++g) {
+		RlncEncoder encoder(k, symbolSize);
+		RlncDecoder decoder(k, symbolSize);
+		for (uint32_t i = 0; i < k; ++i) {
+			sources[i][0] = g + i;
+			encoder.addSource(sources[i].data());
+			if (i % 3 != 0) {
+				fill(coefs.begin(), coefs.end(), 0);
+				coefs[i] = 1;
+				nDecoded += decoder.addSymbol(coefs.data(), sources[i].data()).size();
+			}
+		}
+		while (!decoder.isComplete()) {
+			for (uint32_t i = 0; i < k; ++i) {
+				coefs[i] = rand() % 255 + 1;
+			}
+			encoder.encodeRepair(coefs.data(), payload.data());
+			nDecoded += decoder.addSymbol(coefs.data(), payload.data()).size();
+		}
+	}
+	cout << "  encode and decode: " << getElapsedNanoSecs(start) / nGenerations / 1000 << " us/generation (" <<
+			nDecoded << " capsules decoded)" << endl;
+}
+
+// A link that delivers 95% of its messages at 20 dB hears noise from period 0 on, dropping to 8 dB
+// and 50%. An Echo and a capsule are sent per period; the convergence time of an estimator is the
+// number of periods until its quality, averaged over the runs, is within 10% of the one for the
+// noisy link.
+void benchLinkEstimator(uint32_t nPeriods, uint32_t nRuns) {
+	cout << "link estimators: noise onset, " << nRuns << " runs of " << nPeriods << " periods" << endl;
+	NodeInfo nodeInfo;
+	nodeInfo.quality_alpha = RntpConfig::QUALITY_ALPHA;
+	mt19937 gen(1);
+	normal_distribution<double> noise(0.0, 2.0);
+	uniform_real_distribution<double> uniform(0.0, 1.0);
+
+	const char* names[] = {"snr", "etx", "hybrid"};
+	for (const char* name : names) {
+		RntpLinkEstimator* estimator = RntpLinkEstimator::create(name);
+		LinkEstimate e_target;
+		estimator->init(e_target, 8.0);
+		e_target.echoPrr = 0.5;
+		e_target.ackPrr = 0.25;
+		e_target.nAckSamples = 1;
+		double quality_target = estimator->getQuality(e_target);
+
+		vector<double> qualities_mean(nPeriods, 0.0);
+		for (uint32_t r = 0; r < nRuns; ++r) {
+			LinkEstimate e;
+			estimator->init(e, 20.0);
+			uint32_t seqNum = 0;
+			for (int t = -(int) nPeriods; t < (int) nPeriods; ++t) {
+				double snr_mean = t < 0 ? 20.0 : 8.0;
+				double prr = t < 0 ? 0.95 : 0.5;
+				if (uniform(gen) < prr) {
+					estimator->onEchoReceived(e, seqNum);
+					estimator->onReceive(e, &nodeInfo, snr_mean + noise(gen));
+				}
+				++seqNum;
+				estimator->onCapAckResult(e, uniform(gen) < prr && uniform(gen) < prr);
+				if (t >= 0) {
+					qualities_mean[t] += estimator->getQuality(e) / nRuns;
+				}
+			}
+		}
+		int period_converged = -1;
+		for (uint32_t t = 0; t < nPeriods && period_converged == -1; ++t) {
+			if (fabs(qualities_mean[t] - quality_target) <= 0.1 * quality_target) {
+				period_converged = t;
+			}
+		}
+		cout << "  " << name << ": " << period_converged << " periods to converge, " <<
+				qualities_mean[nPeriods - 1] << " at the end for " << quality_target << endl;
+		delete estimator;
+	}
+}
+
+// The estimator the liveness detector replaced, as a baseline: arrivals counted in one-second
+// buckets over the last two seconds, with the silence threshold taken from the mean rate as if
+// arrivals were Poisson, at the confidence of PIAT_ESTIMATION_CONFIDENT_RATIO=0.999999.
+class PerSecondRateEstimator {
+public:
+	void recordPacketArrival(double time) {
+		uint32_t secs = (uint32_t) floor(time);
+		if (buckets.size() > 0 && buckets.back().first == secs) {
+			++buckets.back().second;
+		} else {
+			buckets.push_back(make_pair(secs, 1));
+			if (buckets.size() > 2) {
+				buckets.pop_front();
+			}
+		}
+	}
+
+	Time estimateSilenceThreshold(Time maxSilence) {
+		if (buckets.size() < 2) {
+			return maxSilence;
+		}
+		// the current second is still being counted
+		double meanRate = buckets.front().second;
+		double est = -log(1 - 0.999999) / meanRate;
+		return est > maxSilence.GetSeconds() ? maxSilence : Seconds(est);
+	}
+
+private:
+	deque<pair<uint32_t, uint32_t> > buckets;
+};
+
+// A neighbor heard through its Echoes, one per second with some jitter, alternates with periods in
+// which it is the next hop of a flow and returns an ACK every 20-30 ms; Echoes and ACKs are lost with
+// lossRatio. While this node awaits the ACKs, the threshold is the detector's as for a neighbor
+// carrying data; once the flow stops, it is never below LIVENESS_MIN_SILENCE, as in onWaitMsgTimer.
+// A false positive is a gap reaching the threshold while the neighbor is alive. The neighbor falls
+// silent at the end of each run, and the detection time is the threshold after its last message,
+// given apart for runs ending during a flow and while idle. The detector is compared with MSG_TIMEOUT
+// as a fixed threshold and with the per-second rate estimator it replaced.
+void benchLivenessDetector(uint32_t nMsgs, uint32_t nRuns, double lossRatio) {
+	cout << "liveness detector: " << nRuns << " runs of " << nMsgs << " messages, loss " << lossRatio << endl;
+	mt19937 gen(1);
+	uniform_real_distribution<double> uniform(0.0, 1.0);
+	Time echoPeriod = Seconds(RntpConfig::ECHO_PERIOD_IN_SECS);
+	Time minSilence = Seconds(RntpConfig::LIVENESS_MIN_SILENCE_IN_SECS);
+	Time maxSilence = Seconds(RntpConfig::MSG_TIMEOUT_IN_SECS);
+	Time minSilence_idle = minSilence < maxSilence ? minSilence : maxSilence;
+	double minIntervals = minSilence.GetSeconds() / echoPeriod.GetSeconds();
+	uint32_t nFalsePositives_forwarding = 0, nFalsePositives_idle = 0, nFalsePositives_fixed = 0, nFalsePositives_rate = 0;
+	uint32_t nRuns_forwarding = 0;
+	double detectionTime_forwarding = 0, detectionTime_idle = 0, detectionTime_rate_total = 0;
+	for (uint32_t r = 0; r < nRuns; ++r) {
+		LivenessDetector detector(RntpConfig::LIVENESS_WINDOW_SIZE, RntpConfig::LIVENESS_PHI_THRESHOLD,
+									Seconds(RntpConfig::LIVENESS_MIN_STD_DEV_IN_SECS), echoPeriod);
+		PerSecondRateEstimator rateEstimator;
+		double now = 0;
+		bool isForwarding = false;
+		Time threshold = maxSilence;
+		Time threshold_rate = maxSilence;
+		for (uint32_t i = 0; i < nMsgs; ++i) {
+			if (uniform(gen) < 0.01) {
+				isForwarding = !isForwarding;
+			}
+			double gap = 0;
+			do {
+				gap += isForwarding ? 0.02 + uniform(gen) * 0.01 : 1.0 + (uniform(gen) - 0.5) * 0.1;
+			} while (uniform(gen) < lossRatio);
+			if (i > 0) {
+				Time threshold_eff = threshold;
+				if (!isForwarding && threshold_eff < minSilence_idle) {
+					threshold_eff = minSilence_idle;
+				}
+				if (Seconds(gap) >= threshold_eff) {
+					++(isForwarding ? nFalsePositives_forwarding : nFalsePositives_idle);
+				}
+				nFalsePositives_fixed += Seconds(gap) >= maxSilence;
+				nFalsePositives_rate += Seconds(gap) >= threshold_rate;
+			}
+			now += gap;
+			detector.recordPacketArrival(Seconds(now), isForwarding);
+			threshold = detector.estimateSilenceThreshold(minIntervals, minSilence, maxSilence);
+			rateEstimator.recordPacketArrival(now);
+			threshold_rate = rateEstimator.estimateSilenceThreshold(maxSilence);
+		}
+		if (isForwarding) {
+			++nRuns_forwarding;
+			detectionTime_forwarding += threshold.GetSeconds();
+		} else {
+			detectionTime_idle += (threshold < minSilence_idle ? minSilence_idle : threshold).GetSeconds();
+		}
+		detectionTime_rate_total += threshold_rate.GetSeconds();
+	}
+	uint32_t nRuns_idle = nRuns - nRuns_forwarding;
+	cout << "  detector: " << (nRuns_forwarding > 0 ? detectionTime_forwarding / nRuns_forwarding : 0) <<
+			" s to detect a silent next hop during a flow, " << (nRuns_idle > 0 ? detectionTime_idle / nRuns_idle : 0) <<
+			" s while idle, " << nFalsePositives_forwarding << " + " << nFalsePositives_idle <<
+			" false positives in " << nRuns * nMsgs << " gaps during flows and while idle" << endl;
+	cout << "  fixed: " << maxSilence.GetSeconds() << " s to detect a silent neighbor, " << nFalsePositives_fixed <<
+			" false positives" << endl;
+	cout << "  per-second rate: " << detectionTime_rate_total / nRuns << " s to detect a silent neighbor, " <<
+			nFalsePositives_rate << " false positives" << endl;
+}
+
+// A neighbor heard only through its Echoes, lost with lossRatio, whose interval doubles after every
+// Echo up to maxPeriod as with Trickle Echoes, or stays at ECHO_PERIOD with maxPeriod equal to it.
+// Each run lasts nSecs, after which the neighbor dies at a random point of its Echo interval; the
+// detection latency is from its death to the end of the threshold after its last message heard.
+void benchEchoTrickle(double nSecs, uint32_t nRuns, double lossRatio, Time maxPeriod) {
+	mt19937 gen(1);
+	uniform_real_distribution<double> uniform(0.0, 1.0);
+	Time echoPeriod = Seconds(RntpConfig::ECHO_PERIOD_IN_SECS);
+	Time minSilence = Seconds(RntpConfig::LIVENESS_MIN_SILENCE_IN_SECS);
+	Time maxSilence = Seconds(RntpConfig::MSG_TIMEOUT_IN_SECS);
+	double minIntervals = minSilence.GetSeconds() / echoPeriod.GetSeconds();
+	uint64_t nEchoes = 0;
+	uint32_t nFalsePositives = 0;
+	double latency_total = 0;
+	for (uint32_t r = 0; r < nRuns; ++r) {
+		LivenessDetector detector(RntpConfig::LIVENESS_WINDOW_SIZE, RntpConfig::LIVENESS_PHI_THRESHOLD,
+									Seconds(RntpConfig::LIVENESS_MIN_STD_DEV_IN_SECS), echoPeriod);
+		Time threshold = maxSilence;
+		double interval = echoPeriod.GetSeconds();
+		double now = 0, lastHeard = 0;
+		while (now < nSecs) {
+			now += interval;
+			interval = min(interval * 2, maxPeriod.GetSeconds());
+			++nEchoes;
+			if (uniform(gen) < lossRatio) {
+				continue;
+			}
+			nFalsePositives += Seconds(now - lastHeard) >= threshold;
+			lastHeard = now;
+			detector.recordPacketArrival(Seconds(now), false);
+			threshold = detector.estimateSilenceThreshold(minIntervals, minSilence, maxSilence);
+		}
+		double deathTime = now + uniform(gen) * interval;
+		latency_total += max(lastHeard + threshold.GetSeconds() - deathTime, 0.0);
+	}
+	cout << "  max period " << maxPeriod.GetSeconds() << " s: " << nEchoes * 60.0 / (nRuns * nSecs) << " Echoes/min, " <<
+			latency_total / nRuns << " s to detect a dead neighbor, " << nFalsePositives << " false positives" << endl;
+}
+
+// Timer load of a node whose nNeighbors each send it a message, and to each of which it sends a
+// capsule, every interval, with messages lost and capsules left unacknowledged with lossRatio. An
+// acknowledged capsule's ACK comes after rtt. The baseline gives every timer its own ns-3 event, as
+// before the timer wheel: a received message cancels and reschedules its neighbor's liveness event
+// with MSG_TIMEOUT, and an ACK removes the capsule's retransmission event. The scheduler holds the
+// timer events scheduled and neither executed nor removed, the cancelled ones included; the events
+// driving the load are left out of every count.
+class TimerLoad {
+public:
+	TimerLoad(bool isWheel, uint32_t nNeighbors, double lossRatio, Time interval, Time rtt) : isWheel(isWheel),
+			nNeighbors(nNeighbors), lossRatio(lossRatio), interval(interval), rtt(rtt), gen(1), uniform(0.0, 1.0),
+			waitMsgEvents(nNeighbors), waitMsgTimerIDs(nNeighbors, 0), waitMsgExpiries(nNeighbors), waitMsgDeadlines(nNeighbors),
+			nScheduled(0), nRemoved(0), nDriverTicks(0), nTimersFired(0), heapSize_max(0), heapSize_total(0), nSamples(0) {
+		msgTimeout = Seconds(RntpConfig::MSG_TIMEOUT_IN_SECS);
+		rto = Seconds(RntpConfig::CAPSULE_PER_HOP_TIMEOUT);
+		wheel.setTick(Seconds(RntpConfig::TIMER_WHEEL_TICK_IN_SECS));
+		eventCount_start = Simulator::GetEventCount();
+	}
+
+	void run(Time duration) {
+		end = duration;
+		Simulator::Schedule(Seconds(0), &TimerLoad::onDriverTick, this);
+		Simulator::Run();
+	}
+
+	uint64_t countEvents() {
+		return Simulator::GetEventCount() - eventCount_start - nDriverTicks;
+	}
+
+	uint64_t countScheduled() {
+		return nScheduled + wheel.nTickEventsScheduled;
+	}
+
+	bool isWheel;
+	uint32_t nNeighbors;
+	double lossRatio;
+	Time interval;
+	Time rtt;
+	Time msgTimeout;
+	Time rto;
+	Time end;
+	mt19937 gen;
+	uniform_real_distribution<double> uniform;
+	TimerWheel wheel;
+	vector<EventId> waitMsgEvents;
+	vector<uint64_t> waitMsgTimerIDs;
+	vector<Time> waitMsgExpiries;
+	vector<Time> waitMsgDeadlines;
+	struct CapsuleSent {
+		Time		sendTime;
+		bool		isLost;
+		EventId		sendEvent;
+		uint64_t	sendTimerID;
+	};
+	deque<CapsuleSent> capsulesSent;
+	uint64_t eventCount_start;
+	uint64_t nScheduled;
+	uint64_t nRemoved;
+	uint64_t nDriverTicks;
+	uint64_t nTimersFired;
+	uint64_t heapSize_max;
+	double heapSize_total;
+	uint64_t nSamples;
+
+private:
+	void onDriverTick() {
+		++nDriverTicks;
+		Time now = Simulator::Now();
+		while (!capsulesSent.empty() && capsulesSent.front().sendTime + rtt <= now) {
+			CapsuleSent& cs = capsulesSent.front();
+			if (!cs.isLost) {
+				if (isWheel) {
+					wheel.cancel(cs.sendTimerID);
+				} else {
+					Simulator::Remove(cs.sendEvent);
+					++nRemoved;
+				}
+			}
+			capsulesSent.pop_front();
+		}
+		for (uint32_t i = 0; i < nNeighbors; ++i) {
+			if (uniform(gen) >= lossRatio) {
+				onMsgReceived(i);
+			}
+			CapsuleSent cs;
+			cs.sendTime = now;
+			cs.isLost = uniform(gen) < lossRatio;
+			if (isWheel) {
+				cs.sendTimerID = wheel.schedule(rto, [this]() { ++this->nTimersFired; });
+			} else {
+				++nScheduled;
+				cs.sendEvent = Simulator::Schedule(rto, &TimerLoad::onTimer, this);
+			}
+			capsulesSent.push_back(cs);
+		}
+
+		uint64_t heapSize = countScheduled() - nRemoved - countEvents();
+		heapSize_max = max(heapSize_max, heapSize);
+		heapSize_total += heapSize;
+		++nSamples;
+		if (now + interval < end) {
+			Simulator::Schedule(interval, &TimerLoad::onDriverTick, this);
+		}
+	}
+
+	// as RntpStrategy::updateChannelQuality, before and after the timer wheel
+	void onMsgReceived(uint32_t i) {
+		if (!isWheel) {
+			Simulator::Cancel(waitMsgEvents[i]);
+			++nScheduled;
+			waitMsgEvents[i] = Simulator::Schedule(msgTimeout, &TimerLoad::onTimer, this);
+			return;
+		}
+		waitMsgDeadlines[i] = Simulator::Now() + msgTimeout;
+		if (!wheel.isPending(waitMsgTimerIDs[i]) || waitMsgExpiries[i] > waitMsgDeadlines[i]) {
+			wheel.cancel(waitMsgTimerIDs[i]);
+			waitMsgExpiries[i] = waitMsgDeadlines[i];
+			waitMsgTimerIDs[i] = wheel.schedule(msgTimeout, [this, i]() { this->onWaitMsgTimer(i); });
+		}
+	}
+
+	// as RntpStrategy::onWaitMsgTimer, which re-arms itself until the deadline
+	void onWaitMsgTimer(uint32_t i) {
+		Time now = Simulator::Now();
+		if (waitMsgDeadlines[i] > now) {
+			waitMsgExpiries[i] = waitMsgDeadlines[i];
+			waitMsgTimerIDs[i] = wheel.schedule(waitMsgDeadlines[i] - now, [this, i]() { this->onWaitMsgTimer(i); });
+			return;
+		}
+		++nTimersFired;
+	}
+
+	void onTimer() {
+		++nTimersFired;
+	}
+};
+
+void benchTimers(uint32_t nNeighbors, double nSecs, double lossRatio) {
+	cout << "timers: " << nNeighbors << " neighbors, a message and a capsule per neighbor every 10 ms for " << nSecs <<
+			" s, loss " << lossRatio << endl;
+	for (bool isWheel : {false, true}) {
+		TimerLoad* load = new TimerLoad(isWheel, nNeighbors, lossRatio, MilliSeconds(10), MilliSeconds(20));
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		load->run(Seconds(nSecs));
+		double elapsed = getElapsedNanoSecs(start);
+		cout << "  " << (isWheel ? "timer wheel" : "per-timer events") << ": " << load->countScheduled() <<
+				" ns-3 events scheduled, " << load->countEvents() << " executed, scheduler holding " <<
+				load->heapSize_total / load->nSamples << " on average and " << load->heapSize_max << " at most, " <<
+				load->nTimersFired << " timers fired, " << elapsed / 1e6 << " ms" << endl;
+		delete load;
+		Simulator::Destroy();
+	}
+}
+
+// One flow of nCapsules down a chain of nHops, in slots of a capsule's airtime, each hop keeping
+// as many capsules in flight as its AIMD window allows. Frames in the MAC queues contend with a
+// random backoff; a node senses the nodes one hop away, so a node two hops from a sender may send
+// at once and collide at its receiver, and a frame is also lost with lossRatio. The MAC drops a
+// frame after 7 failed attempts, and a capsule not delivered within CAPSULE_PER_HOP_TIMEOUT is sent
+// again, as per-hop retransmissions are, even when still queued in the MAC. Without pacing, a node
+// hands every capsule its window allows to the MAC; with it, one every PACING_HOPS_SHARING_CHANNEL
+// airtimes. ACKs are taken as free.
+struct PacedHop {
+	deque<uint32_t> 			sendQueue;
+	deque<pair<uint32_t, uint32_t> > macQueue;   // capsule and MAC attempts failed
+	unordered_map<uint32_t, uint64_t> inFlight;   // capsule -> slot of its per-hop timeout
+	uint64_t					releaseSlot_next;
+	uint32_t					window;
+	uint32_t					slowStartThres;
+};
+
+void benchPacing(uint32_t nHops, uint32_t nCapsules, uint32_t nRuns, double lossRatio) {
+	cout << "pacing: " << nRuns << " runs of " << nCapsules << " capsules over " << nHops << " hops, frame loss " <<
+			lossRatio << endl;
+	double airtime = RntpConfig::PACING_FRAME_OVERHEAD_IN_SECS + 1024 * 8.0 / (RntpConfig::PACING_PHY_RATE_IN_MBPS * 1e6);
+	uint64_t timeoutSlots = (uint64_t) ceil(RntpConfig::CAPSULE_PER_HOP_TIMEOUT / airtime);
+	for (bool isPaced : {false, true}) {
+		mt19937 gen(1);
+		uniform_real_distribution<double> uniform(0.0, 1.0);
+		uint64_t nRetransmissions = 0, nMacDrops = 0, nDelivered = 0, nSlots_total = 0;
+		double latency_total = 0, latency_sqTotal = 0;
+		for (uint32_t r = 0; r < nRuns; ++r) {
+			vector<PacedHop> hops(nHops);
+			vector<bool> isReceived((nHops + 1) * nCapsules, false);
+			vector<uint64_t> firstSendSlot(nCapsules, 0);
+			for (uint32_t c = 0; c < nCapsules; ++c) {
+				hops[0].sendQueue.push_back(c);
+			}
+			for (uint32_t i = 0; i < nHops; ++i) {
+				hops[i].releaseSlot_next = 0;
+				hops[i].window = RntpConfig::CONGESTION_CONTROL_INIT_WIN;
+				hops[i].slowStartThres = RntpConfig::CONGESTION_CONTROL_THRESHOLD;
+			}
+			uint32_t nArrived = 0;
+			uint64_t slot = 0;
+			for (; nArrived < nCapsules; ++slot) {
+				for (uint32_t i = 0; i < nHops; ++i) {
+					PacedHop& hop = hops[i];
+					for (auto iter = hop.inFlight.begin(); iter != hop.inFlight.end(); ++iter) {
+						if (iter->second <= slot) {
+							hop.macQueue.push_back(make_pair(iter->first, 0));
+							iter->second = slot + timeoutSlots;
+							++nRetransmissions;
+							hop.window = max(hop.window / 2, 1u);
+							hop.slowStartThres = max(hop.slowStartThres / 2, 1u);
+						}
+					}
+					while (hop.sendQueue.size() > 0 && hop.inFlight.size() < hop.window && hop.releaseSlot_next <= slot) {
+						uint32_t c = hop.sendQueue.front();
+						hop.sendQueue.pop_front();
+						hop.macQueue.push_back(make_pair(c, 0));
+						hop.inFlight[c] = slot + timeoutSlots;
+						if (i == 0) {
+							firstSendSlot[c] = slot;
+						}
+						if (isPaced) {
+							hop.releaseSlot_next = slot + RntpConfig::PACING_HOPS_SHARING_CHANNEL;
+						}
+					}
+				}
+
+				// contenders in order of their backoffs, which double with the attempts failed
+				vector<pair<uint32_t, uint32_t> > backoffs;
+				for (uint32_t i = 0; i < nHops; ++i) {
+					if (hops[i].macQueue.size() > 0) {
+						uint32_t cw = min(16u << hops[i].macQueue.front().second, 1024u);
+						backoffs.push_back(make_pair((uint32_t) (gen() % cw), i));
+					}
+				}
+				sort(backoffs.begin(), backoffs.end());
+				vector<int> backoffSending(nHops + 1, -1);
+				for (auto& b : backoffs) {
+					uint32_t i = b.second;
+					bool isSensed = false;
+					for (uint32_t k = (i > 0 ? i - 1 : 0); k <= i + 1 && k < nHops; ++k) {
+						isSensed = isSensed || (k != i && backoffSending[k] != -1 && backoffSending[k] < (int) b.first);
+					}
+					if (!isSensed) {
+						backoffSending[i] = b.first;
+					}
+				}
+				for (uint32_t i = 0; i < nHops; ++i) {
+					if (backoffSending[i] == -1) {
+						continue;
+					}
+					uint32_t j = i + 1;
+					bool isCollided = backoffSending[j] != -1 || (j + 1 <= nHops && backoffSending[j + 1] != -1) ||
+										uniform(gen) < lossRatio;
+					PacedHop& hop = hops[i];
+					uint32_t c = hop.macQueue.front().first;
+					if (isCollided) {
+						if (++hop.macQueue.front().second >= 7) {
+							hop.macQueue.pop_front();
+							++nMacDrops;
+						}
+						continue;
+					}
+					hop.macQueue.pop_front();
+					if (isReceived[j * nCapsules + c]) {
+						continue;
+					}
+					isReceived[j * nCapsules + c] = true;
+					hop.inFlight.erase(c);
+					if (hop.window < hop.slowStartThres) {
+						hop.window *= 2;
+					} else {
+						++hop.window;
+						++hop.slowStartThres;
+					}
+					if (j < nHops) {
+						hops[j].sendQueue.push_back(c);
+					} else {
+						double latency = (slot + 1 - firstSendSlot[c]) * airtime * 1000;
+						latency_total += latency;
+						latency_sqTotal += latency * latency;
+						++nArrived;
+					}
+				}
+			}
+			nSlots_total += slot;
+			nDelivered += nArrived;
+		}
+		double latency_mean = latency_total / nDelivered;
+		cout << "  pacing " << (isPaced ? "on" : "off") << ": " << (double) nRetransmissions / nRuns <<
+				" per-hop retransmissions and " << (double) nMacDrops / nRuns << " MAC drops per run, delivery latency " <<
+				latency_mean << " ms on average, variance " << max(latency_sqTotal / nDelivered - latency_mean * latency_mean, 0.0) <<
+				" ms^2, " << nDelivered / (nSlots_total * airtime) << " capsules/s" << endl;
+	}
+}
+
+int main(int argc, char *argv[]) {
+	uint32_t iterations = 10000;
+	uint32_t nPairs = 64;
+	uint32_t nRoutesPerPair = 16;
+	uint32_t nHops = 8;
+	uint32_t window = 128;
+	uint32_t backlog = 1000;
+	string configFilePath = "sart-config.ini";
+
+	CommandLine cmd;
+	cmd.AddValue("iterations", "number of iterations of each benchmark", iterations);
+	cmd.AddValue("pairs", "number of consumer-producer pairs", nPairs);
+	cmd.AddValue("routes", "number of routes per pair", nRoutesPerPair);
+	cmd.AddValue("hops", "number of hops per route", nHops);
+	cmd.AddValue("window", "congestion window of the capsule queue", window);
+	cmd.AddValue("backlog", "number of capsules queued at a relay", backlog);
+	cmd.AddValue("config", "configuration file whose settings the benchmarks use", configFilePath);
+	cmd.Parse(argc, argv);
+	if (!RntpConfig::loadConfigFile(configFilePath)) {
+		cerr << "cannot load " << configFilePath << ", running with the built-in defaults" << endl;
+	}
+
+	benchRouteStore(nPairs, nRoutesPerPair, nHops, iterations);
+	benchCapsuleQueue(window, backlog, iterations / 10);
+	benchSendCapStatePool(window, iterations * 100);
+	benchCoding(8, iterations);
+	benchLinkEstimator(200, iterations / 100);
+	benchLivenessDetector(1000, iterations / 100, 0.0);
+	benchLivenessDetector(1000, iterations / 100, 0.01);
+	benchLivenessDetector(1000, iterations / 100, 0.1);
+	for (double lossRatio : {0.0, 0.01, 0.1}) {
+		cout << "Echo Trickle: " << iterations / 100 << " runs of an idle link for 1 h, Echo loss " << lossRatio << endl;
+		benchEchoTrickle(3600, iterations / 100, lossRatio, Seconds(RntpConfig::ECHO_PERIOD_IN_SECS));
+		benchEchoTrickle(3600, iterations / 100, lossRatio, Seconds(RntpConfig::ECHO_MAX_PERIOD_IN_SECS));
+	}
+	benchTimers(4, 60, 0.01);
+	benchTimers(16, 60, 0.01);
+	for (double lossRatio : {0.0, 0.1}) {
+		benchPacing(4, 1000, iterations / 1000, lossRatio);
+		benchPacing(8, 1000, iterations / 1000, lossRatio);
+	}
+
+	return 0;
+}
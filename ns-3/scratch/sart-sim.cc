@@ -24,7 +24,10 @@
 #include <ctime>
 #include <regex>
 #include <random>
+#include <chrono>
 #include <unordered_map>
+#include <fstream>
+#include <unistd.h>
 
 using namespace std;
 using namespace ns3;
@@ -170,12 +173,58 @@ void setNodeInfo(string nameSpace, NodeInfo* ni, uint32_t id) {
 	ni->capsuleRetryingMaxTimes = RntpConfig::CAPSULE_RETRYING_TIMES;
 	ni->congestionControlSlowStartThres = RntpConfig::CONGESTION_CONTROL_THRESHOLD;
 	ni->congestionControlInitWin = RntpConfig::CONGESTION_CONTROL_INIT_WIN;
+	ni->congestionControlAlgorithm = RntpConfig::CONGESTION_CONTROL;
+	ni->testTimesToIdentifyLinkAwaken = RntpConfig::TEST_TIMES_TO_IDENTIFY_LINK_AWAKEN;
+	ni->periodToIdentifyLinkAwaken = ns3::Seconds(RntpConfig::PERIOD_IN_SECS_TO_IDENTIFY_LINK_AWAKEN);
 	ni->echoPeriod = ns3::Seconds(RntpConfig::ECHO_PERIOD_IN_SECS);
 	ni->msgTimeout = ns3::Seconds(RntpConfig::MSG_TIMEOUT_IN_SECS);
 	ni->interestContentionTimeInSecs = RntpConfig::INTEREST_CONTENTION_TIME_IN_SECS;
 	ni->quality_alpha = RntpConfig::QUALITY_ALPHA;
-	ni->thQueueSize = RntpConfig::THROUGHPUT_QUEUE_SIZE_IN_SECS;
-	ni->longestPIATEstCondifentRatio = RntpConfig::PIAT_ESTIMATION_CONFIDENT_RATIO;
+	ni->linkEstimatorName = RntpConfig::LINK_ESTIMATOR;
+	ni->livenessWindowSize = RntpConfig::LIVENESS_WINDOW_SIZE;
+	ni->livenessPhiThreshold = RntpConfig::LIVENESS_PHI_THRESHOLD;
+	ni->livenessMinStdDev = ns3::Seconds(RntpConfig::LIVENESS_MIN_STD_DEV_IN_SECS);
+	ni->livenessMinSilence = ns3::Seconds(RntpConfig::LIVENESS_MIN_SILENCE_IN_SECS);
+	ni->routeMaxPerPair = RntpConfig::ROUTE_MAX_PER_PAIR;
+	ni->routeTableMaxRoutes = RntpConfig::ROUTE_TABLE_MAX_ROUTES;
+	ni->routeIdleTimeout = ns3::Seconds(RntpConfig::ROUTE_IDLE_TIMEOUT_IN_SECS);
+	ni->routeStaleTimeout = ns3::Seconds(RntpConfig::ROUTE_STALE_TIMEOUT_IN_SECS);
+	ni->routeAgingPeriod = ns3::Seconds(RntpConfig::ROUTE_AGING_PERIOD_IN_SECS);
+	ni->dataIDWindowSize = RntpConfig::DATA_ID_WINDOW_SIZE;
+	ni->cache_maxSize = RntpConfig::CACHE_MAX_SIZE_IN_PACKETS;
+	ni->timerWheelTick = ns3::Seconds(RntpConfig::TIMER_WHEEL_TICK_IN_SECS);
+	ni->stripingEnabled = RntpConfig::STRIPING_ENABLED;
+	ni->stripingMaxPaths = RntpConfig::STRIPING_MAX_PATHS;
+	ni->stripingMaxReorder = RntpConfig::STRIPING_MAX_REORDER;
+	ni->stripingDeliveryAlpha = RntpConfig::STRIPING_DELIVERY_ALPHA;
+	ni->pacingEnabled = RntpConfig::PACING_ENABLED;
+	ni->pacingPhyRate = RntpConfig::PACING_PHY_RATE_IN_MBPS * 1e6;
+	ni->pacingFrameOverhead = ns3::Seconds(RntpConfig::PACING_FRAME_OVERHEAD_IN_SECS);
+	ni->pacingHopsSharingChannel = RntpConfig::PACING_HOPS_SHARING_CHANNEL;
+	ni->pacingGain = RntpConfig::PACING_GAIN;
+	ni->opportunisticForwardingEnabled = RntpConfig::OPPORTUNISTIC_FORWARDING_ENABLED;
+	ni->opportunisticForwardingSlot = ns3::Seconds(RntpConfig::OPPORTUNISTIC_FORWARDING_SLOT_IN_SECS);
+	ni->adaptiveRtoEnabled = RntpConfig::ADAPTIVE_RTO_ENABLED;
+	ni->rtoMin = ns3::Seconds(RntpConfig::RTO_MIN_IN_SECS);
+	ni->rtoMax = ns3::Seconds(RntpConfig::RTO_MAX_IN_SECS);
+	ni->echoTrickleEnabled = RntpConfig::ECHO_TRICKLE_ENABLED;
+	ni->echoMaxPeriod = ns3::Seconds(RntpConfig::ECHO_MAX_PERIOD_IN_SECS);
+	ni->interestSuppressionEnabled = RntpConfig::INTEREST_SUPPRESSION_ENABLED;
+	ni->interestSuppressionCopies = RntpConfig::INTEREST_SUPPRESSION_COPIES;
+	ni->interestSuppressionDegree = RntpConfig::INTEREST_SUPPRESSION_DEGREE;
+	ni->discoveryHopSlack = RntpConfig::DISCOVERY_HOP_SLACK;
+	ni->discoveryMinQuality = RntpConfig::DISCOVERY_MIN_QUALITY;
+	ni->routeMetricQualityWeight = RntpConfig::ROUTE_METRIC_QUALITY_WEIGHT;
+	ni->routeMetricHopWeight = RntpConfig::ROUTE_METRIC_HOP_WEIGHT;
+	ni->routeMetricQueueWeight = RntpConfig::ROUTE_METRIC_QUEUE_WEIGHT;
+	ni->routeMetricEnergyWeight = RntpConfig::ROUTE_METRIC_ENERGY_WEIGHT;
+	ni->routeMetricQueueCapacity = RntpConfig::ROUTE_METRIC_QUEUE_CAPACITY;
+	ni->dutyCycleEnabled = RntpConfig::DUTY_CYCLE_ENABLED;
+	ni->dutyCyclePeriod = ns3::Seconds(RntpConfig::DUTY_CYCLE_PERIOD_IN_SECS);
+	ni->dutyCycleAwakeTime = ns3::Seconds(RntpConfig::DUTY_CYCLE_AWAKE_IN_SECS);
+	ni->capsuleRepairEnabled = RntpConfig::CAPSULE_REPAIR_ENABLED;
+	ni->capsuleRepairDelay = ns3::Seconds(RntpConfig::CAPSULE_REPAIR_DELAY_IN_SECS);
+	ni->capsuleRepairTimes = RntpConfig::CAPSULE_REPAIR_TIMES;
 }
 
 std::unordered_set<int> generateRandomInterferedNodes(int k, int numNodes, int consumerNodeIdx, int sensorNodeIdx) {
@@ -242,6 +291,30 @@ double getSourceInitialEnegeryJ(double batteryVoltage, double batteryCapacityInm
 	return batteryVoltage * batteryCapacityInmAh * 0.001 * 3600;
 }
 
+// the network lifetime: when the first node drains its battery down to the low-battery threshold
+double networkLifetimeInSecs = -1;
+
+void checkNetworkLifetime(EnergySourceContainer sources, double lowBatteryFraction) {
+	for (uint32_t i = 0; i < sources.GetN(); ++i) {
+		if (sources.Get(i)->GetEnergyFraction() <= lowBatteryFraction) {
+			networkLifetimeInSecs = Simulator::Now().GetSeconds();
+			return;
+		}
+	}
+	Simulator::Schedule(Seconds(1), &checkNetworkLifetime, sources, lowBatteryFraction);
+}
+
+// the resident memory of the simulator every period of simulated time, which stays flat over a long
+// run unless per-flow or per-capsule states leak
+void sampleMemory(double periodSecs) {
+	ifstream statm("/proc/self/statm");
+	size_t nPages_total = 0, nPages_resident = 0;
+	statm >> nPages_total >> nPages_resident;
+	cout << "# Memory: " << Simulator::Now().GetSeconds() << " s, RSS (KiB): " <<
+			nPages_resident * sysconf(_SC_PAGESIZE) / 1024 << endl;
+	Simulator::Schedule(Seconds(periodSecs), &sampleMemory, periodSecs);
+}
+
 void PhyRxDropCallback (std::string context, Ptr<const Packet> packet, WifiPhyRxfailureReason reason)
 {
 	stringstream ss;
@@ -321,6 +394,7 @@ main(int argc, char* argv[])
 
 	WifiPhy::enableRntpExtension = true;
 	RntpStrategy::enableLog_msgs = true;
+	CapsuleQueue::enableLog = RntpConfig::LOG_CAPSULE_QUEUE;
 
 	uint32_t numNodes = RntpConfig::N_NODES;
 	uint32_t gridWidthInNodes = RntpConfig::GRID_WIDTH_IN_NODES;
@@ -427,6 +501,10 @@ main(int argc, char* argv[])
 		::nfd::Forwarder* forwarder = proto->getForwarder().get();
 		NodeInfo* ni = new NodeInfo;
 		setNodeInfo(nameSpace, ni, i);
+		ni->residualEnergyFraction = MakeCallback(&EnergySource::GetEnergyFraction, sources.Get(i));
+		Ptr<WifiPhy> phy = DynamicCast<WifiNetDevice>(wifiNetDevices.Get(i))->GetPhy();
+		ni->sleepRadio = MakeCallback(&WifiPhy::SetSleepMode, phy);
+		ni->wakeRadio = MakeCallback(&WifiPhy::ResumeFromSleep, phy);
 
 		NodeInfoManager::boundForwarderWithRoutes(forwarder, i, ni);
 	}
@@ -443,6 +521,7 @@ main(int argc, char* argv[])
 	Ptr<GenericConsumer> app_consumer = ns3::DynamicCast<GenericConsumer>(ac_consumer.Get(0));
 	app_consumer->setNodeID(consumerNodeIdx);
 	app_consumer->setMaxWaitTime(ns3::Seconds(RntpConfig::CONSUMER_MAX_WAIT_TIME_IN_SECS));
+	app_consumer->setCoding(RntpConfig::CODING_ENABLED);
 	app_consumer->SetStartTime(Seconds(0.0));
 	app_consumer->SetStopTime(Seconds(SIM_TIME_SECS));
 
@@ -456,6 +535,7 @@ main(int argc, char* argv[])
 	Ptr<generic::GenericSensorApp> sensorApp = ns3::DynamicCast<generic::GenericSensorApp, Application>(sensorAC.Get(0));
 	sensorApp->setSensorName(sensorNodeName);
 	sensorApp->setFreq(RntpConfig::PRODUCER_FREQ);
+	sensorApp->setCoding(RntpConfig::CODING_ENABLED, RntpConfig::CODING_GENERATION_SIZE, RntpConfig::CODING_REPAIRS_PER_GENERATION);
 	sensorApp->SetStartTime(Seconds(0.0));
 	sensorApp->SetStopTime(Seconds(SIM_TIME_SECS));
 
@@ -482,12 +562,25 @@ main(int argc, char* argv[])
 
 	Config::Connect ("/NodeList/*/DeviceList/*/Phy/PhyRxDrop", MakeCallback (&PhyRxDropCallback));
 
+	DoubleValue lowBatteryThreshold;
+	sources.Get(0)->GetAttribute("BasicEnergyLowBatteryThreshold", lowBatteryThreshold);
+	checkNetworkLifetime(sources, lowBatteryThreshold.Get());
+	if (RntpConfig::MEMORY_SAMPLE_PERIOD_IN_SECS > 0) {
+		sampleMemory(RntpConfig::MEMORY_SAMPLE_PERIOD_IN_SECS);
+	}
+
 	Simulator::Stop(Seconds(SIM_TIME_SECS + EXTENSION_TIME_SECS));
 
+	auto runStart = std::chrono::steady_clock::now();
 	Simulator::Run();
+	double runSecs = std::chrono::duration<double>(std::chrono::steady_clock::now() - runStart).count();
+	double simTimeInSecs = Simulator::Now().GetSeconds();
+	cout << "# Events executed: " << Simulator::GetEventCount() << ", events/s: " << Simulator::GetEventCount() / runSecs << endl;
 	auto log = RntpUtils::getLogEnergy();
+	double energyConsumed_total = 0;
 	for (uint32_t i = 0; i < numNodes; ++i) {
 		double energyConsumed = deviceModels.Get(i)->GetTotalEnergyConsumption();
+		energyConsumed_total += energyConsumed;
 		double energyRemained = sources.Get(i)->GetRemainingEnergy();
 		double supplyVoltage = sources.Get(i)->GetSupplyVoltage();
 		*log << i << "," << Simulator::Now() << ",Final," << energyConsumed << "," << energyRemained << "," << supplyVoltage << endl;
@@ -496,6 +589,59 @@ main(int argc, char* argv[])
 	Simulator::Destroy();
 
 	cout << "# Capsule sent: " << sensorApp->getNCapsuleSent() << ", # Capsule recv: " << app_consumer->getNRecvCapsules() << endl;
+	// one line per run, for comparing congestion-control algorithms on the same scenario
+	cout << "# Summary: " << RntpConfig::CONGESTION_CONTROL << ", throughput (capsules/s): " <<
+			app_consumer->getNRecvCapsules() / SIM_TIME_SECS << ", energy (J): " << energyConsumed_total <<
+			", energy per capsule recv (J): " << (app_consumer->getNRecvCapsules() > 0 ?
+			energyConsumed_total / app_consumer->getNRecvCapsules() : 0) << ", per-hop retransmissions: " <<
+			RntpStrategy::nCapsuleRetransmissions << ", Echoes sent: " << RntpStrategy::nEchoesSent << ", Echoes suppressed: " <<
+			RntpStrategy::nEchoesSuppressed << ", network lifetime (s): " <<
+			(networkLifetimeInSecs >= 0 ? to_string(networkLifetimeInSecs) : "-") << endl;
+	// what Trickle Echoes save in control messages, against how long a neighbor's silence lasts
+	// before its link is taken as broken, and how often that happens
+	cout << "# Echo: trickle " << (RntpConfig::ECHO_TRICKLE_ENABLED ? "on" : "off") << ", Echoes sent: " <<
+			RntpStrategy::nEchoesSent << ", suppressed: " << RntpStrategy::nEchoesSuppressed << ", links broken by silence: " <<
+			RntpStrategy::nLinksBrokenBySilence << ", mean silence before breaking (s): " <<
+			(RntpStrategy::nLinksBrokenBySilence > 0 ?
+			RntpStrategy::secsSilentBeforeBroken_total / RntpStrategy::nLinksBrokenBySilence : 0) << endl;
+	// discovery completeness against its cost, with and without InterestBroadcast suppression
+	cout << "# Discovery: InterestBroadcasts sent: " << RntpStrategy::nInterestBroadcastsSent << ", suppressed: " <<
+			RntpStrategy::nInterestBroadcastsSuppressed << ", skipped: " << RntpStrategy::nInterestBroadcastsSkipped <<
+			", nodes reached: " << RntpStrategy::nNodesReached << endl;
+	double latency_total = 0, latency_sqTotal = 0;   // in ms
+	uint32_t nLatencies = 0;
+	for (auto iter = app_consumer->getRecvTimes().begin(); iter != app_consumer->getRecvTimes().end(); ++iter) {
+		auto iter_sent = GenericLog::TimeSendingData.find(iter->first);
+		if (iter_sent != GenericLog::TimeSendingData.end()) {
+			double latency = (iter->second - iter_sent->second).GetSeconds() * 1000;
+			latency_total += latency;
+			latency_sqTotal += latency * latency;
+			++nLatencies;
+		}
+	}
+	double latency_mean = nLatencies > 0 ? latency_total / nLatencies : 0;
+	double latency_var = nLatencies > 0 ? max(latency_sqTotal / nLatencies - latency_mean * latency_mean, 0.0) : 0;
+	// what duty cycling saves in energy, against what it adds to the delivery latency
+	cout << "# Duty cycle: " << (RntpConfig::DUTY_CYCLE_ENABLED ? "on" : "off") << ", radio asleep (%): " <<
+			100 * RntpStrategy::secsAsleep_total / (numNodes * simTimeInSecs) << ", energy (J): " << energyConsumed_total <<
+			", mean delivery latency (ms): " << latency_mean << endl;
+	// what pacing saves in retransmissions, and how much steadier it makes the delivery latency
+	cout << "# Pacing: " << (RntpConfig::PACING_ENABLED ? "on" : "off") << ", per-hop retransmissions: " <<
+			RntpStrategy::nCapsuleRetransmissions << ", mean delivery latency (ms): " << latency_mean <<
+			", delivery latency variance (ms^2): " << latency_var << ", throughput (capsules/s): " <<
+			app_consumer->getNRecvCapsules() / SIM_TIME_SECS << endl;
+	// how many repairs a copy on the path served, and the hops to the producer each of them saved
+	uint64_t nRepairsAnswered = RntpStrategy::nCapsuleRepairHits + RntpStrategy::nCapsuleRepairMisses;
+	cout << "# Capsule repair: " << (RntpConfig::CAPSULE_REPAIR_ENABLED ? "on" : "off") << ", requested: " <<
+			RntpStrategy::nCapsuleRepairsRequested << ", served: " << RntpStrategy::nCapsuleRepairHits << ", missed: " <<
+			RntpStrategy::nCapsuleRepairMisses << ", hit rate (%): " <<
+			(nRepairsAnswered > 0 ? 100.0 * RntpStrategy::nCapsuleRepairHits / nRepairsAnswered : 0) <<
+			", mean hops saved: " << (RntpStrategy::nCapsuleRepairHits > 0 ?
+			(double) RntpStrategy::nCapsuleRepairHopsSaved / RntpStrategy::nCapsuleRepairHits : 0) << endl;
+	if (RntpConfig::CODING_ENABLED) {
+		cout << "# Coding (" << Gf256::getKernelName() << "): repairs sent: " << sensorApp->getNRepairSent() << ", repairs recv: " <<
+				app_consumer->getNRecvRepairs() << ", capsules decoded: " << app_consumer->getNDecodedCapsules() << endl;
+	}
 
 	RntpUtils::closeLogs();
 
@@ -4,6 +4,7 @@
 #include "NFD/daemon/face/face-common.hpp"
 #include "ns3/ndnSIM/model/ndn-common.hpp"
 #include "ns3/ptr.h"
+#include "ns3/callback.h"
 #include "NFD/daemon/fw/forwarder.hpp"
 #include "NFD/daemon/face/face-common.hpp"
 //#include "model/lltc/lltc-resilient-routes-subgraph.hpp"
@@ -35,6 +36,7 @@ struct NodeInfo {
 	uint32_t		capsuleRetryingMaxTimes;
 	uint32_t		congestionControlSlowStartThres;
 	uint32_t		congestionControlInitWin;
+	string			congestionControlAlgorithm;
 	uint32_t		testTimesToIdentifyLinkAwaken;
 	ns3::Time		periodToIdentifyLinkAwaken;
 	ns3::Time 		echoPeriod;
@@ -42,10 +44,55 @@ struct NodeInfo {
 	ns3::Time		CQUpdateDelayTime;
 	ns3::Time		msgTimeout;
 	double			quality_alpha;
+	string			linkEstimatorName;
 	size_t			cache_maxSize;
 	uint32_t		maxTimesForRevokingToSendCapsule;
-	uint32_t		thQueueSize;
-	double			longestPIATEstCondifentRatio;
+	uint32_t		livenessWindowSize;
+	double			livenessPhiThreshold;
+	ns3::Time		livenessMinStdDev;
+	ns3::Time		livenessMinSilence;   // of an Echo-only neighbor; below three Echo periods, two Echoes lost in a row break the link
+	uint32_t		routeMaxPerPair;
+	uint32_t		routeTableMaxRoutes;
+	ns3::Time		routeIdleTimeout;     // zero disables the eviction of idle pairs
+	ns3::Time		routeStaleTimeout;    // zero disables the eviction of stale routes
+	ns3::Time		routeAgingPeriod;
+	uint32_t		dataIDWindowSize;
+	ns3::Time		timerWheelTick;
+	bool			stripingEnabled;
+	uint32_t		stripingMaxPaths;
+	uint32_t		stripingMaxReorder;
+	double			stripingDeliveryAlpha;
+	bool			pacingEnabled;
+	double			pacingPhyRate;
+	ns3::Time		pacingFrameOverhead;
+	uint32_t		pacingHopsSharingChannel;
+	double			pacingGain;
+	bool			opportunisticForwardingEnabled;
+	ns3::Time		opportunisticForwardingSlot;
+	bool			adaptiveRtoEnabled;
+	ns3::Time		rtoMin;
+	ns3::Time		rtoMax;
+	bool			echoTrickleEnabled;
+	ns3::Time		echoMaxPeriod;
+	bool			interestSuppressionEnabled;
+	uint32_t		interestSuppressionCopies;
+	uint32_t		interestSuppressionDegree;
+	uint32_t		discoveryHopSlack;
+	double			discoveryMinQuality;
+	double			routeMetricQualityWeight;
+	double			routeMetricHopWeight;
+	double			routeMetricQueueWeight;
+	double			routeMetricEnergyWeight;
+	uint32_t		routeMetricQueueCapacity;
+	ns3::Callback<double>	residualEnergyFraction;   // of the node's energy source, null without one
+	bool			dutyCycleEnabled;
+	ns3::Time		dutyCyclePeriod;
+	ns3::Time		dutyCycleAwakeTime;
+	ns3::Callback<void>		sleepRadio;   // of the node's WifiPhy, null without one
+	ns3::Callback<void>		wakeRadio;
+	bool			capsuleRepairEnabled;
+	ns3::Time		capsuleRepairDelay;
+	uint32_t		capsuleRepairTimes;
 	ns3::Time		ETO;   // for RT-CaCC
 	uint32_t		frpSrcNodeID;  // for FRP
 	uint32_t		frpDstNodeID;  // for FRP
@@ -0,0 +1,283 @@
+/*
+ * This work is licensed under CC BY-NC-SA 4.0
+ * (https://creativecommons.org/licenses/by-nc-sa/4.0/).
+ * Copyright (c) 2025 Boyang Zhou
+ *
+ * This file is a part of "Subpath-Aware Reliable Transport Control Protocol (SART) for Wireless Multihop Networks"
+ * (https://github.com/zhouby-zjl/sart/).
+ * Written by Boyang Zhou (zhouby@zhejianglab.com / zby_zju@163.com)
+ *
+ */
+
+#include "ns3/simulator.h"
+#include "rntp-strategy.hpp"
+
+#include <algorithm>
+
+using namespace std;
+using namespace ns3;
+
+// the most data IDs a gap adds to the missing ones, and a repair request carries
+#define CAPSULE_REPAIR_MAX_GAP		256
+#define CAPSULE_REPAIR_MAX_IDS		64
+
+namespace nfd {
+namespace fw {
+
+CapsuleCache::CapsuleCache() : nInserted(0), nEvicted(0), nHits(0), nMisses(0), hand(0), capacity(0) {
+}
+
+void CapsuleCache::setCapacity(size_t capacity) {
+	this->capacity = capacity;
+	slots.clear();
+	slotsByFlow.clear();
+	hand = 0;
+}
+
+// slots are added until the capacity is reached, and reused by eviction from then on
+void CapsuleCache::insert(uint64_t flowKey, CapsuleInfo& capInfo, const Data& data) {
+	if (capacity == 0) {
+		return;
+	}
+	auto iter_flow = slotsByFlow.find(flowKey);
+	if (iter_flow != slotsByFlow.end()) {
+		auto iter = iter_flow->second.find(capInfo.dataID);
+		if (iter != iter_flow->second.end()) {
+			CachedCapsule& cc = slots[iter->second];
+			cc.capInfo = capInfo;
+			cc.data = data;
+			return;
+		}
+	}
+
+	size_t slot;
+	if (slots.size() < capacity) {
+		slots.emplace_back();
+		slot = slots.size() - 1;
+	} else {
+		slot = evict();
+	}
+	CachedCapsule& cc = slots[slot];
+	cc.flowKey = flowKey;
+	cc.capInfo = capInfo;
+	cc.data = data;
+	cc.isReferenced = false;
+	slotsByFlow[flowKey][capInfo.dataID] = slot;
+	++nInserted;
+}
+
+size_t CapsuleCache::evict() {
+	while (slots[hand].isReferenced) {
+		slots[hand].isReferenced = false;
+		hand = (hand + 1) % slots.size();
+	}
+	size_t slot = hand;
+	hand = (hand + 1) % slots.size();
+
+	auto iter_flow = slotsByFlow.find(slots[slot].flowKey);
+	if (iter_flow != slotsByFlow.end()) {
+		iter_flow->second.erase(slots[slot].capInfo.dataID);
+		if (iter_flow->second.empty()) {
+			slotsByFlow.erase(iter_flow);
+		}
+	}
+	++nEvicted;
+	return slot;
+}
+
+CachedCapsule* CapsuleCache::lookup(uint64_t flowKey, uint32_t dataID) {
+	auto iter_flow = slotsByFlow.find(flowKey);
+	if (iter_flow != slotsByFlow.end()) {
+		auto iter = iter_flow->second.find(dataID);
+		if (iter != iter_flow->second.end()) {
+			CachedCapsule& cc = slots[iter->second];
+			cc.isReferenced = true;
+			++nHits;
+			return &cc;
+		}
+	}
+	++nMisses;
+	return NULL;
+}
+
+size_t CapsuleCache::countElements() {
+	return slots.size();
+}
+
+size_t CapsuleCache::getCapacity() {
+	return capacity;
+}
+
+// kept once the next hop has acknowledged it, as the capsule then leaves the queue
+void RntpStrategy::cacheCapsule(TransportStates* ts, uint32_t dataID) {
+	CapsuleToSend* cts = ts->capSendQueue.getElement(dataID);
+	if (cts != NULL) {
+		capsuleCache.insert(getFlowKey(ts->prefixID, ts->consumerID), cts->capInfo, cts->data);
+	}
+}
+
+// A capsule still queued here is already on its way downstream; one cached here is sent again,
+// once forgotten as sent to every next hop, or it would be taken as a duplicate. The windows
+// are all checked first, so that a repair not served leaves none of them changed.
+bool RntpStrategy::serveCapsuleRepair(TransportStates* ts, uint32_t dataID) {
+	if (ts->capSendQueue.isDataIDInBuffer(dataID)) {
+		return true;
+	}
+	CachedCapsule* cc = capsuleCache.lookup(getFlowKey(ts->prefixID, ts->consumerID), dataID);
+	if (cc == NULL) {
+		return false;
+	}
+	for (auto iter = ts->sentDataIDsPerNextHop.begin(); iter != ts->sentDataIDsPerNextHop.end(); ++iter) {
+		if (!iter->second.isErasable(dataID)) {
+			return false;
+		}
+	}
+	for (auto iter = ts->sentDataIDsPerNextHop.begin(); iter != ts->sentDataIDsPerNextHop.end(); ++iter) {
+		iter->second.erase(dataID);
+	}
+	CapsuleInfo capInfo = cc->capInfo;
+	Data data = cc->data;
+	sendCapsuleViaQueue(ts, capInfo, data, SEND_CAP_FROM_PERVIOUS_HOP);
+	return true;
+}
+
+// At the consumer, the data IDs skipped below the highest one received are missing; they are
+// asked from the path of the latest capsule once the repair delay has passed without them, as
+// striped capsules may only be reordered.
+void RntpStrategy::trackCapsuleGaps(TransportStates* ts, CapsuleInfo& capInfo) {
+	ts->dataIDsMissing.erase(capInfo.dataID);
+
+	auto iter = std::find(capInfo.nodeIDs.begin(), capInfo.nodeIDs.end(), this->nodeInfo->nodeID);
+	if (iter != capInfo.nodeIDs.end() && ++iter != capInfo.nodeIDs.end()) {
+		ts->upstreamNodeIDs_repair.assign(iter, capInfo.nodeIDs.end());
+	}
+
+	if (ts->isDataIDSeen && capInfo.dataID > ts->dataID_highest) {
+		uint32_t dataID_first = ts->dataID_highest + 1;
+		if (capInfo.dataID - dataID_first > CAPSULE_REPAIR_MAX_GAP) {
+			dataID_first = capInfo.dataID - CAPSULE_REPAIR_MAX_GAP;
+		}
+		for (uint32_t dataID = dataID_first; dataID < capInfo.dataID; ++dataID) {
+			MissingCapsule& mc = ts->dataIDsMissing[dataID];
+			mc.lastTime = Simulator::Now();
+			mc.nRepairsSent = 0;
+		}
+	}
+	if (!ts->isDataIDSeen || capInfo.dataID > ts->dataID_highest) {
+		ts->isDataIDSeen = true;
+		ts->dataID_highest = capInfo.dataID;
+	}
+
+	if (!ts->dataIDsMissing.empty() && !ts->isRepairTimerSet) {
+		scheduleCapsuleRepair(ts);
+	}
+}
+
+void RntpStrategy::scheduleCapsuleRepair(TransportStates* ts) {
+	ts->isRepairTimerSet = true;
+	ts->repairTimerID = timerWheel.schedule(this->nodeInfo->capsuleRepairDelay, [this, ts]() {
+		this->onCapsuleRepairTimer(ts);
+	});
+}
+
+// a missing capsule asked for capsuleRepairTimes in vain is left to the consumer's wait timer
+void RntpStrategy::onCapsuleRepairTimer(TransportStates* ts) {
+	ts->isRepairTimerSet = false;
+	ns3::Time dueTime = Simulator::Now() - this->nodeInfo->capsuleRepairDelay + this->nodeInfo->timerWheelTick;
+	list<uint32_t> dataIDsToRepair;
+	for (auto iter = ts->dataIDsMissing.begin(); iter != ts->dataIDsMissing.end(); ) {
+		MissingCapsule& mc = iter->second;
+		if (mc.lastTime > dueTime || dataIDsToRepair.size() == CAPSULE_REPAIR_MAX_IDS) {
+			++iter;
+		} else if (mc.nRepairsSent == this->nodeInfo->capsuleRepairTimes) {
+			iter = ts->dataIDsMissing.erase(iter);
+		} else {
+			dataIDsToRepair.push_back(iter->first);
+			mc.lastTime = Simulator::Now();
+			++mc.nRepairsSent;
+			++iter;
+		}
+	}
+
+	if (dataIDsToRepair.size() > 0 && ts->upstreamNodeIDs_repair.size() > 0) {
+		nCapsuleRepairsRequested += dataIDsToRepair.size();
+		sendCapsuleRepair(ts->prefixID, dataIDsToRepair, this->nodeInfo->nodeID, ts->upstreamNodeIDs_repair, ts->consumerID);
+	}
+	if (!ts->dataIDsMissing.empty()) {
+		scheduleCapsuleRepair(ts);
+	}
+}
+
+// Only the first node of the upstream path acts on a repair: it serves what it holds and asks the
+// rest from the nodes behind it, and what is still missing at the producer's end is a miss.
+void RntpStrategy::onReceiveCapsuleRepair(const FaceEndpoint& ingress, const Data& data) {
+	CapsuleRepairInfo info;
+	this->extractCapsuleRepair(data, info);
+	PhyInfo phyInfo;
+	this->extractPhyInfo(data, phyInfo);
+
+	updateChannelQuality(info.requesterNodeID, phyInfo.snr, false);
+
+	if (info.upstreamNodeIDs.size() == 0 || info.upstreamNodeIDs.front() != this->nodeInfo->nodeID) {
+		return;
+	}
+	info.upstreamNodeIDs.pop_front();
+
+	if (enableLog_msgs) {
+		cout << "[Node " << nodeInfo->nodeID << ", " << Simulator::Now().GetMicroSeconds() <<
+				" us] receives a CapsuleRepair from " << info.requesterNodeID << ", dataIDs: ";
+		for (auto iter = info.dataIDsMissing.begin(); iter != info.dataIDsMissing.end(); ++iter) {
+			cout << *iter << " ";
+		}
+		cout << endl;
+	}
+
+	auto iter = this->transportStates_all.find(getFlowKey(info.prefixID, info.consumerNodeID));
+	TransportStates* ts = iter != this->transportStates_all.end() ? iter->second : NULL;
+	list<uint32_t> dataIDsMissing;
+	for (uint32_t dataID : info.dataIDsMissing) {
+		if (ts != NULL && serveCapsuleRepair(ts, dataID)) {
+			++nCapsuleRepairHits;
+			nCapsuleRepairHopsSaved += info.upstreamNodeIDs.size();
+		} else {
+			dataIDsMissing.push_back(dataID);
+		}
+	}
+
+	if (dataIDsMissing.size() == 0) {
+		return;
+	}
+	if (info.upstreamNodeIDs.size() == 0) {
+		nCapsuleRepairMisses += dataIDsMissing.size();
+		return;
+	}
+	sendCapsuleRepair(info.prefixID, dataIDsMissing, this->nodeInfo->nodeID, info.upstreamNodeIDs, info.consumerNodeID);
+}
+
+void RntpStrategy::sendCapsuleRepair(uint32_t prefixID, list<uint32_t>& dataIDsMissing, uint32_t requesterNodeID,
+									list<uint32_t>& upstreamNodeIDs, uint32_t consumerNodeID) {
+	CapsuleRepairInfo info;
+	info.prefixID = prefixID;
+	info.dataIDsMissing = dataIDsMissing;
+	info.requesterNodeID = requesterNodeID;
+	info.upstreamNodeIDs = upstreamNodeIDs;
+	info.consumerNodeID = consumerNodeID;
+
+	shared_ptr<Data> data = this->constructCapsuleRepair(info);
+	holdRadioAwake();
+	FaceEndpoint egress(*this->face_netdev, 0);
+	egress.face.sendData(*data, egress.endpoint);
+	onMsgSent();
+
+	if (enableLog_msgs) {
+		cout << "[Node " << nodeInfo->nodeID << ", " << Simulator::Now().GetMicroSeconds() <<
+				" us] sends a CapsuleRepair to " << upstreamNodeIDs.front() << ", dataIDs: ";
+		for (auto iter = dataIDsMissing.begin(); iter != dataIDsMissing.end(); ++iter) {
+			cout << *iter << " ";
+		}
+		cout << endl;
+	}
+}
+
+}
+}
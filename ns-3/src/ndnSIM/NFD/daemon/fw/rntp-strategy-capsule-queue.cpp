@@ -42,84 +42,166 @@ using namespace ns3;
 namespace nfd {
 namespace fw {
 
+bool CapsuleQueue::enableLog = true;
+
 CapsuleQueue::CapsuleQueue() {
 	nHiddenElements = 0;
 }
 
+CapsuleQueue::~CapsuleQueue() {
+	for (auto iter = nodesByDataID.begin(); iter != nodesByDataID.end(); ++iter) {
+		delete iter->second;
+	}
+}
+
 void CapsuleQueue::setNodeID(uint32_t nodeID) {
 	this->nodeID = nodeID;
 }
 
+void CapsuleQueue::insertAfter(NodeList& nodeList, CapsuleQueueNode* pos, CapsuleQueueNode* node) {
+	node->prev = pos;
+	node->next = pos == NULL ? nodeList.head : pos->next;
+	if (node->next != NULL) {
+		node->next->prev = node;
+	} else {
+		nodeList.tail = node;
+	}
+	if (pos != NULL) {
+		pos->next = node;
+	} else {
+		nodeList.head = node;
+	}
+}
+
+void CapsuleQueue::unlink(NodeList& nodeList, CapsuleQueueNode* node) {
+	if (node->prev != NULL) {
+		node->prev->next = node->next;
+	} else {
+		nodeList.head = node->next;
+	}
+	if (node->next != NULL) {
+		node->next->prev = node->prev;
+	} else {
+		nodeList.tail = node->prev;
+	}
+	node->prev = NULL;
+	node->next = NULL;
+}
+
+CapsuleQueue::NodeList& CapsuleQueue::getWaitingList(CapsuleQueueNode* node) {
+	return node->isRestored ? restored : ready;
+}
+
 void CapsuleQueue::removeElement(int dataID) {
-    auto it = buffer.begin();
-    while (it != buffer.end()) {
-        if (it->capInfo.dataID == dataID) {
-        	if (it->hidden) {
-        		--nHiddenElements;
-        	}
-            it = buffer.erase(it);
-            dataIDsInBuffer.erase(dataID);
-        } else {
-            ++it;
-        }
-    }
-    logBuffer();
+	auto iter = nodesByDataID.find(dataID);
+	if (iter == nodesByDataID.end()) {
+		return;
+	}
+	CapsuleQueueNode* node = iter->second;
+	if (node->element.hidden) {
+		unlink(inflight, node);
+		--nHiddenElements;
+	} else {
+		unlink(getWaitingList(node), node);
+	}
+	nodesByDataID.erase(iter);
+	delete node;
+	logBuffer();
 }
 
 bool CapsuleQueue::isDataIDInBuffer(uint32_t dataID) {
-	return dataIDsInBuffer.find(dataID) != dataIDsInBuffer.end();
+	return nodesByDataID.find(dataID) != nodesByDataID.end();
 }
 
 void CapsuleQueue::pushElement(CapsuleToSend& element) {
-	element.hidden = false;
-	buffer.push_back(element);
-	dataIDsInBuffer.insert(element.capInfo.dataID);
+	if (isDataIDInBuffer(element.capInfo.dataID)) {
+		return;
+	}
+	CapsuleQueueNode* node = new CapsuleQueueNode;
+	node->element = element;
+	node->element.hidden = false;
+	node->isRestored = false;
+	insertAfter(ready, ready.tail, node);
+	nodesByDataID[element.capInfo.dataID] = node;
 	logBuffer();
 }
 
 void CapsuleQueue::transientlyPopElement() {
-	for (auto iter = buffer.begin(); iter != buffer.end(); ++iter) {
-		if (!iter->hidden) {
-			iter->hidden = true;
-			++nHiddenElements;
-			logBuffer();
-			return;
-		}
+	CapsuleQueueNode* node = restored.head != NULL ? restored.head : ready.head;
+	if (node == NULL) {
+		return;
+	}
+	unlink(getWaitingList(node), node);
+	node->element.hidden = true;
+	insertAfter(inflight, inflight.tail, node);
+	++nHiddenElements;
+	logBuffer();
+}
+
+void CapsuleQueue::transientlyPopElement(uint32_t dataID) {
+	auto iter = nodesByDataID.find(dataID);
+	if (iter == nodesByDataID.end() || iter->second->element.hidden) {
+		return;
 	}
+	CapsuleQueueNode* node = iter->second;
+	unlink(getWaitingList(node), node);
+	node->element.hidden = true;
+	insertAfter(inflight, inflight.tail, node);
+	++nHiddenElements;
+	logBuffer();
 }
 
 CapsuleToSend* CapsuleQueue::getFront() {
-	if (!buffer.empty()) {
-		for (auto iter = buffer.begin(); iter != buffer.end(); ++iter) {
-			if (!iter->hidden) {
-				return &(*iter);
-			}
-		}
+	CapsuleQueueNode* node = restored.head != NULL ? restored.head : ready.head;
+	return node == NULL ? NULL : &node->element;
+}
+
+// the waiting capsule after the given one, going on from the restored list into the ready one,
+// or NULL at the end
+CapsuleToSend* CapsuleQueue::getNextReady(CapsuleToSend* element) {
+	auto iter = nodesByDataID.find(element->capInfo.dataID);
+	if (iter == nodesByDataID.end() || iter->second->element.hidden) {
+		return NULL;
 	}
-	return NULL;
+	CapsuleQueueNode* node = iter->second;
+	if (node->next != NULL) {
+		return &node->next->element;
+	}
+	return node->isRestored && ready.head != NULL ? &ready.head->element : NULL;
 }
 
 CapsuleToSend* CapsuleQueue::restoreElement(int id) {
-	for (auto iter = buffer.begin(); iter != buffer.end(); ++iter) {
-		if (iter->capInfo.dataID == id) {
-			if (iter->hidden) {
-				iter->hidden = false;
-				--nHiddenElements;
-				logBuffer();
-			}
-			return &(*iter);
-		}
+	auto iter = nodesByDataID.find(id);
+	if (iter == nodesByDataID.end()) {
+		return NULL;
+	}
+	CapsuleQueueNode* node = iter->second;
+	if (node->element.hidden) {
+		unlink(inflight, node);
+		node->element.hidden = false;
+		--nHiddenElements;
+		node->isRestored = true;
+		insertAfter(restored, restored.tail, node);
+		logBuffer();
 	}
-	return NULL;
+	return &node->element;
+}
+
+CapsuleToSend* CapsuleQueue::getElement(uint32_t dataID) {
+	auto iter = nodesByDataID.find(dataID);
+	return iter != nodesByDataID.end() ? &iter->second->element : NULL;
 }
 
 size_t CapsuleQueue::countElements() {
-    return buffer.size() - nHiddenElements;
+    return nodesByDataID.size() - nHiddenElements;
 }
 
 void CapsuleQueue::logBuffer() {
+	if (!enableLog) {
+		return;
+	}
 	auto log = RntpUtils::getLogBuffer();
-	*log << this->nodeID << "," << Simulator::Now() << "," << buffer.size() << "," << nHiddenElements << endl;
+	*log << this->nodeID << "," << Simulator::Now() << "," << nodesByDataID.size() << "," << nHiddenElements << endl;
 }
 
 }
@@ -0,0 +1,55 @@
+/*
+ * This work is licensed under CC BY-NC-SA 4.0
+ * (https://creativecommons.org/licenses/by-nc-sa/4.0/).
+ * Copyright (c) 2025 Boyang Zhou
+ *
+ * This file is a part of "Subpath-Aware Reliable Transport Control Protocol (SART) for Wireless Multihop Networks"
+ * (https://github.com/zhouby-zjl/sart/).
+ * Written by Boyang Zhou (zhouby@zhejianglab.com / zby_zju@163.com)
+ *
+ */
+
+#include "ns3/simulator.h"
+#include "rntp-strategy.hpp"
+
+#include <cmath>
+
+using namespace std;
+using namespace ns3;
+
+namespace nfd {
+namespace fw {
+
+string BbrCongestionControl::getName() {
+	return "bbr";
+}
+
+void BbrCongestionControl::onAck(NextHopWindow& w, NodeInfo* nodeInfo) {
+	// until the first round has been measured, the window grows as in slow start
+	if (w.deliveryRate_max <= 0 || w.rtt_min.IsZero()) {
+		if (w.window < w.slowStartThres) {
+			++w.window;
+		}
+		return;
+	}
+	int window = (int) ceil(BBR_CWND_GAIN * w.deliveryRate_max * w.rtt_min.GetSeconds());
+	w.window = window > BBR_MIN_WINDOW ? window : BBR_MIN_WINDOW;
+}
+
+// with a measured bandwidth-delay product the window stays, as wireless losses say little of
+// congestion; a noisy hop still loses share through its falling delivery rate
+void BbrCongestionControl::onCapAckTimeout(TransportStates* ts,  NodeInfo* nodeInfo, int nextHopID) {
+	if (nextHopID == -1) {
+		RntpCongestionControl::onCapAckTimeout(ts, nodeInfo, nextHopID);
+		return;
+	}
+	NextHopWindow& w = getWindow(ts, nodeInfo, nextHopID);
+	if (w.deliveryRate_max <= 0 || w.rtt_min.IsZero()) {
+		RntpCongestionControl::onCapAckTimeout(ts, nodeInfo, nextHopID);
+		return;
+	}
+	log("AckTimeout", ts, nodeInfo, nextHopID);
+}
+
+}
+}
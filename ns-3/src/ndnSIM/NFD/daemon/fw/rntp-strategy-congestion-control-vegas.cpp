@@ -0,0 +1,59 @@
+/*
+ * This work is licensed under CC BY-NC-SA 4.0
+ * (https://creativecommons.org/licenses/by-nc-sa/4.0/).
+ * Copyright (c) 2025 Boyang Zhou
+ *
+ * This file is a part of "Subpath-Aware Reliable Transport Control Protocol (SART) for Wireless Multihop Networks"
+ * (https://github.com/zhouby-zjl/sart/).
+ * Written by Boyang Zhou (zhouby@zhejianglab.com / zby_zju@163.com)
+ *
+ */
+
+#include "ns3/simulator.h"
+#include "rntp-strategy.hpp"
+
+using namespace std;
+using namespace ns3;
+
+namespace nfd {
+namespace fw {
+
+string VegasCongestionControl::getName() {
+	return "vegas";
+}
+
+// The capsules queued along the hop are estimated as window * (1 - minRTT / RTT), i.e., the
+// expected minus the actual sending rate, times the minimum RTT.
+void VegasCongestionControl::onAck(NextHopWindow& w, NodeInfo* nodeInfo) {
+	if (w.rtt_min.IsZero() || w.rtt_smooth.IsZero()) {
+		if (w.window < w.slowStartThres) {
+			++w.window;
+		}
+		return;
+	}
+	double nQueued = w.window * (1 - w.rtt_min.GetSeconds() / w.rtt_smooth.GetSeconds());
+
+	// slow start ends as soon as capsules begin to queue
+	if (w.window < w.slowStartThres) {
+		if (nQueued > VEGAS_GAMMA) {
+			w.slowStartThres = w.window;
+		} else {
+			++w.window;
+		}
+		return;
+	}
+
+	ns3::Time now = Simulator::Now();
+	if (now - w.adjustTime < w.rtt_smooth) {
+		return;
+	}
+	w.adjustTime = now;
+	if (nQueued < VEGAS_ALPHA) {
+		++w.window;
+	} else if (nQueued > VEGAS_BETA && w.window > 1) {
+		--w.window;
+	}
+}
+
+}
+}
@@ -42,53 +42,134 @@ using namespace ns3;
 namespace nfd {
 namespace fw {
 
-void RntpCongestionControl::init(TransportStates* ts,  NodeInfo* nodeInfo) {
-	ts->window = nodeInfo->congestionControlInitWin;
-	ts->slowStartThres = nodeInfo->congestionControlSlowStartThres;
-	log("Init", ts, nodeInfo);
+// unknown names fall back to AIMD, the original algorithm
+RntpCongestionControl* RntpCongestionControl::create(string algorithm) {
+	if (algorithm == "vegas") {
+		return new VegasCongestionControl();
+	} else if (algorithm == "bbr") {
+		return new BbrCongestionControl();
+	}
+	return new AimdCongestionControl();
 }
 
-void RntpCongestionControl::onCapAckReceived(TransportStates* ts,  NodeInfo* nodeInfo) {
-	if (ts->window >= 1 && ts->window < ts->slowStartThres) {
-		ts->window *= 2;
-	} else {
-		++ts->window;
-		++ts->slowStartThres;
+// windows are opened lazily, the first time a flow sends towards a next hop
+NextHopWindow& RntpCongestionControl::getWindow(TransportStates* ts,  NodeInfo* nodeInfo, uint32_t nextHopID) {
+	auto iter = ts->windowsPerNextHop.find(nextHopID);
+	if (iter != ts->windowsPerNextHop.end()) {
+		return iter->second;
+	}
+	NextHopWindow& w = ts->windowsPerNextHop[nextHopID];
+	w.window = nodeInfo->congestionControlInitWin;
+	w.slowStartThres = nodeInfo->congestionControlSlowStartThres;
+	w.nInFlight = 0;
+	w.deliveryRate_max = 0;
+	w.nDelivered_round = 0;
+	log("Init", ts, nodeInfo, nextHopID);
+	return w;
+}
+
+bool RntpCongestionControl::isWindowAvailable(TransportStates* ts,  NodeInfo* nodeInfo, uint32_t nextHopID) {
+	NextHopWindow& w = getWindow(ts, nodeInfo, nextHopID);
+	return w.window > 0 && w.nInFlight < (uint32_t) w.window;
+}
+
+void RntpCongestionControl::onCapSent(TransportStates* ts,  NodeInfo* nodeInfo, uint32_t nextHopID) {
+	++getWindow(ts, nodeInfo, nextHopID).nInFlight;
+}
+
+void RntpCongestionControl::onCapReleased(TransportStates* ts, uint32_t nextHopID) {
+	auto iter = ts->windowsPerNextHop.find(nextHopID);
+	if (iter != ts->windowsPerNextHop.end() && iter->second.nInFlight > 0) {
+		--iter->second.nInFlight;
 	}
-	log("AckReceived", ts, nodeInfo);
 }
+
+// the RTT is zero when not sampled, e.g., for a retransmitted capsule
+void RntpCongestionControl::onCapAckReceived(TransportStates* ts,  NodeInfo* nodeInfo, uint32_t nextHopID, ns3::Time rtt) {
+	NextHopWindow& w = getWindow(ts, nodeInfo, nextHopID);
+	measure(w, rtt);
+	onAck(w, nodeInfo);
+	log("AckReceived", ts, nodeInfo, nextHopID);
+}
+
+// Smooths and min-filters the RTT, and samples the delivery rate once per round, i.e., per
+// minimum RTT, keeping its maximum over the last BBR_BW_FILTER_ROUNDS rounds.
+void RntpCongestionControl::measure(NextHopWindow& w, ns3::Time rtt) {
+	ns3::Time now = Simulator::Now();
+	if (rtt.IsStrictlyPositive()) {
+		if (w.rtt_smooth.IsZero()) {
+			w.rtt_smooth = rtt;
+		} else {
+			w.rtt_smooth = Seconds((1 - CONGESTION_RTT_ALPHA) * w.rtt_smooth.GetSeconds() + CONGESTION_RTT_ALPHA * rtt.GetSeconds());
+		}
+		if (w.rtt_min.IsZero() || rtt <= w.rtt_min || now - w.rtt_minStamp > Seconds(CONGESTION_RTT_MIN_FILTER_IN_SECS)) {
+			w.rtt_min = rtt;
+			w.rtt_minStamp = now;
+		}
+	}
+
+	++w.nDelivered_round;
+	if (w.round_start.IsZero()) {
+		w.round_start = now;
+		return;
+	}
+	ns3::Time elapsed = now - w.round_start;
+	if (w.rtt_min.IsZero() || elapsed < w.rtt_min || !elapsed.IsStrictlyPositive()) {
+		return;
+	}
+	double deliveryRate = w.nDelivered_round / elapsed.GetSeconds();
+	if (deliveryRate >= w.deliveryRate_max || now - w.deliveryRate_stamp > Seconds(w.rtt_min.GetSeconds() * BBR_BW_FILTER_ROUNDS)) {
+		w.deliveryRate_max = deliveryRate;
+		w.deliveryRate_stamp = now;
+	}
+	w.nDelivered_round = 0;
+	w.round_start = now;
+}
+
+// only the next hop that timed out backs off; a capsule that was never sent, for want of a route,
+// waits in the queue and leaves every window alone
 void RntpCongestionControl::onCapAckTimeout(TransportStates* ts,  NodeInfo* nodeInfo, int nextHopID) {
 	if (nextHopID == -1) {
-		ts->window = 0;
-		log("NoRoute", ts, nodeInfo);
+		log("NoRoute", ts, nodeInfo, nextHopID);
 		return;
 	}
-	if (ts->window > 0) {
-		ts->window /= 2;
+	NextHopWindow& w = getWindow(ts, nodeInfo, nextHopID);
+	if (w.window > 0) {
+		w.window /= 2;
 	}
-	if (ts->window == 0) {
-		ts->window = 1;
+	if (w.window == 0) {
+		w.window = 1;
 	}
-	ts->slowStartThres /= 2;
-	if (ts->slowStartThres == 0) {
-		ts->slowStartThres = 1;
+	w.slowStartThres /= 2;
+	if (w.slowStartThres == 0) {
+		w.slowStartThres = 1;
 	}
-	log("AckTimeout", ts, nodeInfo);
+	log("AckTimeout", ts, nodeInfo, nextHopID);
 }
 
-void RntpCongestionControl::onChannelWaken(TransportStates* ts,  NodeInfo* nodeInfo, int fromNodeID) {
-	if (ts->window == 0) {
-		ts->window = nodeInfo->congestionControlInitWin;
-		ts->slowStartThres = nodeInfo->congestionControlSlowStartThres;
+void RntpCongestionControl::log(string reason, TransportStates* ts,  NodeInfo* nodeInfo, int nextHopID) {
+	ofstream* log = RntpUtils::getLogCongestionControl();
+	*log << nodeInfo->nodeID << "," << Simulator::Now() << "," << reason << "," << nextHopID << ",";
+	auto iter = nextHopID == -1 ? ts->windowsPerNextHop.end() : ts->windowsPerNextHop.find(nextHopID);
+	if (iter != ts->windowsPerNextHop.end()) {
+		*log << iter->second.window << "," << iter->second.slowStartThres << "," << iter->second.nInFlight << "," <<
+				iter->second.rtt_smooth.GetSeconds() << "," << iter->second.deliveryRate_max;
+	} else {
+		*log << "0,0,0,0,0";
 	}
-	log("Waken", ts, nodeInfo);
+	*log << "," << ts->capSendQueue.countElements() << endl;
+}
+string AimdCongestionControl::getName() {
+	return "aimd";
 }
 
-void RntpCongestionControl::log(string reason, TransportStates* ts,  NodeInfo* nodeInfo) {
-	ofstream* log = RntpUtils::getLogCongestionControl();
-	*log << nodeInfo->nodeID << "," << Simulator::Now() << "," << reason << "," << ts->window
-			<< "," << ts->slowStartThres << ","
-			<< ts->capSendQueue.countElements() << endl;
+void AimdCongestionControl::onAck(NextHopWindow& w, NodeInfo* nodeInfo) {
+	if (w.window >= 1 && w.window < w.slowStartThres) {
+		w.window *= 2;
+	} else {
+		++w.window;
+		++w.slowStartThres;
+	}
 }
 
 }
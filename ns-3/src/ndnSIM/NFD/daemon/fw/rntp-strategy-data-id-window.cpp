@@ -0,0 +1,81 @@
+/*
+ * This work is licensed under CC BY-NC-SA 4.0
+ * (https://creativecommons.org/licenses/by-nc-sa/4.0/).
+ * Copyright (c) 2025 Boyang Zhou
+ *
+ * This file is a part of "Subpath-Aware Reliable Transport Control Protocol (SART) for Wireless Multihop Networks"
+ * (https://github.com/zhouby-zjl/sart/).
+ * Written by Boyang Zhou (zhouby@zhejianglab.com / zby_zju@163.com)
+ *
+ */
+
+#include "rntp-strategy.hpp"
+
+using namespace std;
+
+namespace nfd {
+namespace fw {
+
+DataIDWindow::DataIDWindow(uint32_t size) : base(0) {
+	nBits = (size == 0 ? 1 : (size + 63) / 64) * 64;
+	words.assign(nBits / 64, 0);
+}
+
+// a data ID below the window has slid out long ago and is reported as sent, so that
+// a very late duplicate is suppressed rather than forwarded again
+bool DataIDWindow::contains(uint32_t dataID) {
+	if (dataID < base) {
+		return true;
+	}
+	if (dataID - base >= nBits) {
+		return false;
+	}
+	uint32_t bit = dataID % nBits;
+	return (words[bit / 64] >> (bit % 64)) & 1;
+}
+
+void DataIDWindow::insert(uint32_t dataID) {
+	if (dataID < base) {
+		return;
+	}
+	if (dataID - base >= nBits) {
+		slideTo(dataID - nBits + 1);
+	}
+	uint32_t bit = dataID % nBits;
+	words[bit / 64] |= (uint64_t) 1 << (bit % 64);
+}
+
+// a data ID below the window cannot be forgotten, as it is reported as sent anyway
+bool DataIDWindow::erase(uint32_t dataID) {
+	if (!isErasable(dataID)) {
+		return false;
+	}
+	if (dataID - base < nBits) {
+		uint32_t bit = dataID % nBits;
+		words[bit / 64] &= ~((uint64_t) 1 << (bit % 64));
+	}
+	return true;
+}
+
+bool DataIDWindow::isErasable(uint32_t dataID) {
+	return dataID >= base;
+}
+
+void DataIDWindow::slideTo(uint32_t base_new) {
+	if (base_new - base >= nBits) {
+		words.assign(words.size(), 0);
+	} else {
+		for (uint32_t dataID = base; dataID != base_new; ++dataID) {
+			uint32_t bit = dataID % nBits;
+			words[bit / 64] &= ~((uint64_t) 1 << (bit % 64));
+		}
+	}
+	base = base_new;
+}
+
+size_t DataIDWindow::getMemoryUsage() {
+	return sizeof(DataIDWindow) + words.capacity() * sizeof(uint64_t);
+}
+
+}
+}
@@ -0,0 +1,87 @@
+/*
+ * This work is licensed under CC BY-NC-SA 4.0
+ * (https://creativecommons.org/licenses/by-nc-sa/4.0/).
+ * Copyright (c) 2025 Boyang Zhou
+ *
+ * This file is a part of "Subpath-Aware Reliable Transport Control Protocol (SART) for Wireless Multihop Networks"
+ * (https://github.com/zhouby-zjl/sart/).
+ * Written by Boyang Zhou (zhouby@zhejianglab.com / zby_zju@163.com)
+ *
+ */
+
+#include "ns3/simulator.h"
+#include "rntp-strategy.hpp"
+
+using namespace std;
+using namespace ns3;
+
+namespace nfd {
+namespace fw {
+
+// With duty cycling, the radios of all nodes wake up together for dutyCycleAwakeTime at the start
+// of every dutyCyclePeriod, aligned on the simulation clock, and sleep for the rest of it. A node
+// that sends capsules or their ACKs, or takes part in a discovery, stays awake until it has done
+// neither for periodToIdentifyLinkAwaken, so that the members of live subpaths do not sleep.
+
+ns3::Time RntpStrategy::getNextDutyCycleSlot() {
+	int64_t period = this->nodeInfo->dutyCyclePeriod.GetNanoSeconds();
+	int64_t now = Simulator::Now().GetNanoSeconds();
+	return NanoSeconds((now + period - 1) / period * period);
+}
+
+void RntpStrategy::onDutyCycleSlot() {
+	if (isRadioAsleep) {
+		setRadioAsleep(false);
+		// a few Echoes in the window let the neighbors tell the link is awake, and resume the
+		// capsules they hold for this node
+		for (uint32_t i = 0; i < this->nodeInfo->testTimesToIdentifyLinkAwaken; ++i) {
+			Simulator::Schedule(Seconds(rand->GetValue(0, this->nodeInfo->dutyCycleAwakeTime.GetSeconds())),
+								&RntpStrategy::sendEcho, this);
+		}
+	}
+	Simulator::Cancel(sleepEvent);
+	sleepEvent = Simulator::Schedule(this->nodeInfo->dutyCycleAwakeTime, &RntpStrategy::trySleepRadio, this);
+	dutyCycleEvent = Simulator::Schedule(this->nodeInfo->dutyCyclePeriod, &RntpStrategy::onDutyCycleSlot, this);
+}
+
+void RntpStrategy::trySleepRadio() {
+	ns3::Time now = Simulator::Now();
+	if (awakeHoldUntil > now) {
+		sleepEvent = Simulator::Schedule(awakeHoldUntil - now, &RntpStrategy::trySleepRadio, this);
+		return;
+	}
+	setRadioAsleep(true);
+}
+
+void RntpStrategy::holdRadioAwake() {
+	if (!this->nodeInfo->dutyCycleEnabled) {
+		return;
+	}
+	awakeHoldUntil = Simulator::Now() + this->nodeInfo->periodToIdentifyLinkAwaken;
+	if (isRadioAsleep) {
+		setRadioAsleep(false);
+		Simulator::Cancel(sleepEvent);
+		sleepEvent = Simulator::Schedule(this->nodeInfo->periodToIdentifyLinkAwaken, &RntpStrategy::trySleepRadio, this);
+	}
+}
+
+void RntpStrategy::setRadioAsleep(bool asleep) {
+	if (asleep == isRadioAsleep) {
+		return;
+	}
+	if (asleep) {
+		if (!this->nodeInfo->sleepRadio.IsNull()) {
+			this->nodeInfo->sleepRadio();
+		}
+		sleepStartTime = Simulator::Now();
+	} else {
+		if (!this->nodeInfo->wakeRadio.IsNull()) {
+			this->nodeInfo->wakeRadio();
+		}
+		secsAsleep_total += (Simulator::Now() - sleepStartTime).GetSeconds();
+	}
+	isRadioAsleep = asleep;
+}
+
+}
+}
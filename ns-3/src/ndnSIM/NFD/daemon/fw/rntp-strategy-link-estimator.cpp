@@ -0,0 +1,105 @@
+/*
+ * This work is licensed under CC BY-NC-SA 4.0
+ * (https://creativecommons.org/licenses/by-nc-sa/4.0/).
+ * Copyright (c) 2025 Boyang Zhou
+ *
+ * This file is a part of "Subpath-Aware Reliable Transport Control Protocol (SART) for Wireless Multihop Networks"
+ * (https://github.com/zhouby-zjl/sart/).
+ * Written by Boyang Zhou (zhouby@zhejianglab.com / zby_zju@163.com)
+ *
+ */
+
+#include "rntp-strategy.hpp"
+
+using namespace std;
+
+namespace nfd {
+namespace fw {
+
+// unknown names fall back to the SNR average, the original estimator
+RntpLinkEstimator* RntpLinkEstimator::create(string name) {
+	if (name == "etx") {
+		return new EtxLinkEstimator();
+	} else if (name == "hybrid") {
+		return new HybridLinkEstimator();
+	}
+	return new SnrLinkEstimator();
+}
+
+double RntpLinkEstimator::getAdvertisedQuality(LinkEstimate& e, double snr) {
+	return getQuality(e);
+}
+
+void RntpLinkEstimator::init(LinkEstimate& e, double snr) {
+	e.snr_smooth = snr;
+	e.echoPrr = 1.0;
+	e.isEchoSeen = false;
+	e.echoSeqNum_last = 0;
+	e.ackPrr = 1.0;
+	e.nAckSamples = 0;
+}
+
+void RntpLinkEstimator::onReceive(LinkEstimate& e, NodeInfo* nodeInfo, double snr) {
+	e.snr_smooth = (1 - nodeInfo->quality_alpha) * e.snr_smooth + nodeInfo->quality_alpha * snr;
+}
+
+// every Echo missing before this one counts as a loss; a sequence number going back means the
+// neighbor has restarted
+void RntpLinkEstimator::onEchoReceived(LinkEstimate& e, uint32_t seqNum) {
+	if (e.isEchoSeen && seqNum > e.echoSeqNum_last) {
+		uint32_t nLost = min(seqNum - e.echoSeqNum_last - 1, (uint32_t) LINK_PRR_MAX_GAP);
+		for (uint32_t i = 0; i < nLost; ++i) {
+			e.echoPrr *= 1 - LINK_PRR_ALPHA;
+		}
+		e.echoPrr = (1 - LINK_PRR_ALPHA) * e.echoPrr + LINK_PRR_ALPHA;
+	}
+	e.isEchoSeen = true;
+	e.echoSeqNum_last = seqNum;
+}
+
+void RntpLinkEstimator::onCapAckResult(LinkEstimate& e, bool isAcked) {
+	e.ackPrr = (1 - LINK_PRR_ALPHA) * e.ackPrr + (isAcked ? LINK_PRR_ALPHA : 0);
+	++e.nAckSamples;
+}
+
+// 1 / ETX, i.e., the product of the delivery ratios in both directions: a capsule and its ACK
+// sample both at once, whereas Echoes only sample the link towards this node, which is then
+// taken as symmetric
+double RntpLinkEstimator::getDeliveryRatio(LinkEstimate& e) {
+	if (e.nAckSamples > 0) {
+		return e.ackPrr;
+	}
+	return e.echoPrr * e.echoPrr;
+}
+
+string SnrLinkEstimator::getName() {
+	return "snr";
+}
+
+double SnrLinkEstimator::getQuality(LinkEstimate& e) {
+	return e.snr_smooth;
+}
+
+// the SNR of the reception itself, as before link estimators
+double SnrLinkEstimator::getAdvertisedQuality(LinkEstimate& e, double snr) {
+	return snr;
+}
+
+string EtxLinkEstimator::getName() {
+	return "etx";
+}
+
+double EtxLinkEstimator::getQuality(LinkEstimate& e) {
+	return getDeliveryRatio(e);
+}
+
+string HybridLinkEstimator::getName() {
+	return "hybrid";
+}
+
+double HybridLinkEstimator::getQuality(LinkEstimate& e) {
+	return e.snr_smooth * getDeliveryRatio(e);
+}
+
+}
+}
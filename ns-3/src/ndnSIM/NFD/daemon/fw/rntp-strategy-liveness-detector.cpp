@@ -0,0 +1,105 @@
+/*
+ * This work is licensed under CC BY-NC-SA 4.0
+ * (https://creativecommons.org/licenses/by-nc-sa/4.0/).
+ * Copyright (c) 2025 Boyang Zhou
+ *
+ * This file is a part of "Subpath-Aware Reliable Transport Control Protocol (SART) for Wireless Multihop Networks"
+ * (https://github.com/zhouby-zjl/sart/).
+ * Written by Boyang Zhou (zhouby@zhejianglab.com / zby_zju@163.com)
+ *
+ */
+
+#include "rntp-strategy.hpp"
+
+#include <cmath>
+
+using namespace std;
+using namespace ns3;
+
+namespace nfd {
+namespace fw {
+
+LivenessDetector::LivenessDetector(size_t size, double phiThreshold, ns3::Time minStdDev, ns3::Time echoPeriod) :
+		capacity(size > 0 ? size : 1), minStdDev(minStdDev.GetSeconds()), echoPeriod(echoPeriod),
+		hasArrival(false), hasDataArrival(false) {
+	all.next = 0;
+	all.intervals.reserve(capacity);
+	data.next = 0;
+	data.intervals.reserve(capacity);
+	// solves P(X > z) = 10^-phi for the standard normal by bisection
+	double p = pow(10, -phiThreshold);
+	double lo = 0, hi = 40;
+	for (int i = 0; i < 100; ++i) {
+		double mid = (lo + hi) / 2;
+		if (0.5 * erfc(mid / sqrt(2.0)) > p) {
+			lo = mid;
+		} else {
+			hi = mid;
+		}
+	}
+	z = hi;
+}
+
+// a gap between two capsules or ACKs is also kept apart, as Echo gaps before a flow would
+// otherwise stretch its threshold for as long as they stay in the window
+void LivenessDetector::recordPacketArrival(ns3::Time time, bool isData) {
+	if (hasArrival && time >= lastArrival) {
+		double interval = (time - lastArrival).GetSeconds();
+		addInterval(all, interval);
+		if (isData && hasDataArrival && lastDataArrival == lastArrival) {
+			addInterval(data, interval);
+		}
+	}
+	lastArrival = time;
+	hasArrival = true;
+	if (isData) {
+		lastDataArrival = time;
+		hasDataArrival = true;
+	}
+}
+
+void LivenessDetector::addInterval(IntervalWindow& window, double interval) {
+	if (window.intervals.size() < capacity) {
+		window.intervals.push_back(interval);
+	} else {
+		window.intervals[window.next] = interval;
+	}
+	window.next = (window.next + 1) % capacity;
+}
+
+bool LivenessDetector::isCarryingData() {
+	return hasDataArrival && lastArrival - lastDataArrival < echoPeriod;
+}
+
+ns3::Time LivenessDetector::getLastArrival() {
+	return lastArrival;
+}
+
+// Rounded up to the millisecond and capped by maxSilence, which also holds until two inter-arrival
+// times have been seen. It is never below minIntervals mean inter-arrival times, nor, unless the
+// neighbor is carrying data and fitted on its gaps between capsules or ACKs, below minSilence.
+ns3::Time LivenessDetector::estimateSilenceThreshold(double minIntervals, ns3::Time minSilence, ns3::Time maxSilence) {
+	bool isDataFitted = isCarryingData() && data.intervals.size() >= 2;
+	vector<double>& intervals = isDataFitted ? data.intervals : all.intervals;
+	size_t n = intervals.size();
+	if (n < 2) {
+		return maxSilence;
+	}
+	double sum = 0, sumSq = 0;
+	for (double interval : intervals) {
+		sum += interval;
+		sumSq += interval * interval;
+	}
+	double mean = sum / n;
+	double stdDev = sqrt(max(0.0, (sumSq - n * mean * mean) / (n - 1)));
+	double est = mean + z * max(stdDev, minStdDev);
+	est = max(est, minIntervals * mean);
+	if (!isDataFitted) {
+		est = max(est, minSilence.GetSeconds());
+	}
+	est = ceil(est * 1000) / 1000;
+	return est > maxSilence.GetSeconds() ? maxSilence : ns3::Seconds(est);
+}
+
+}
+}
@@ -63,7 +63,7 @@ void RntpStrategy::logMsgInterestBroadcast(bool isRecv, InterestBroadcastInfo& i
 	} else {
 		*log << "t,";
 	}
-	*log << info.consumerNodeID << "," << info.transHopNodeID << "," << info.producerPrefix << "," <<
+	*log << info.consumerNodeID << "," << info.transHopNodeID << "," << prefixInterner.getPrefix(info.producerPrefixID) << "," <<
 			info.hopCount << "," <<	info.nonce << ",";
 	bool begin = true;
 	for (auto iter = info.visitedNodeIDs.begin(); iter != info.visitedNodeIDs.end(); ++iter) {
@@ -96,7 +96,7 @@ void RntpStrategy::logMsgCapsule(bool isRecv, CapsuleInfo& info, PhyInfo* phyInf
 		*log << "s,";
 	}
 
-	*log << info.transHopNodeID << "," << info.prefix << "," << info.dataID << ",";
+	*log << info.transHopNodeID << "," << prefixInterner.getPrefix(info.prefixID) << "," << info.dataID << ",";
 	bool begin = true;
 	for (auto iter = info.nodeIDs.begin(); iter != info.nodeIDs.end(); ++iter) {
 		if (begin) {
@@ -125,7 +125,7 @@ void RntpStrategy::logMsgCapAck(bool isRecv, CapsuleACKInfo& info, PhyInfo* phyI
 		begin = false;
 	}
 	*log << "," << info.downstreamNodeID << "," <<
-			info.prefix << ",";
+			prefixInterner.getPrefix(info.prefixID) << ",";
 	begin = true;
 	for (auto iter = info.dataIDsReceived.begin(); iter != info.dataIDsReceived.end(); ++iter) {
 		if (begin) {
@@ -155,7 +155,8 @@ void RntpStrategy::logRoutes() {
 	*log << this->nodeInfo->nodeID << ",";
 	bool begin_routes, begin_route;
 	for (auto iter = this->routes_all.begin(); iter != this->routes_all.end(); ++iter) {
-		RoutesPerPair* routesPerPair = *iter;
+		RoutesPerPair* routesPerPair = iter->second;
+		refreshRouteMetrics(routesPerPair);
 		*log << this->nodeInfo->nodeID << "," << Simulator::Now() << "," << routesPerPair->consumerNodeID << ","
 				<< routesPerPair->routes.size() << ",";
 		begin_routes = true;
@@ -169,22 +170,23 @@ void RntpStrategy::logRoutes() {
 			*log << route->id << "#" << route->n_hops << "#" << route->updateTime << "#" << route->metric << "#";
 
 			begin_route = true;
-			for (auto iter3 = route->nodeIDs.begin(); iter3 != route->nodeIDs.end(); ++iter3) {
+			const uint32_t* nodeIDs = routesPerPair->store.getNodeIDs(route->slot);
+			for (uint32_t i = 0; i < routesPerPair->store.getNNodes(route->slot); ++i) {
 				if (begin_route) {
-					*log << *iter3;
+					*log << nodeIDs[i];
 					begin_route = false;
 				} else {
-					*log << "-" << *iter3;
+					*log << "-" << nodeIDs[i];
 				}
 			}
 			*log << "#";
 			begin_route = true;
-			for (auto iter3 = route->channelQualities.begin(); iter3 != route->channelQualities.end(); ++iter3) {
+			for (Link* link : route->links) {
 				if (begin_route) {
-					*log << *iter3;
+					*log << link->quality;
 					begin_route = false;
 				} else {
-					*log << "-" << *iter3;
+					*log << "-" << link->quality;
 				}
 			}
 		}
@@ -194,27 +196,74 @@ void RntpStrategy::logRoutes() {
 	}
 }
 
+void RntpStrategy::logRouteTableStats() {
+	auto log = RntpUtils::getLogOthers();
+	*log << this->nodeInfo->nodeID << "," << Simulator::Now() << ",RouteTable," << nRoutes_total << "," <<
+			nRoutes_highWater << "," << nRoutesEvicted_cap << "," << nRoutesEvicted_idle << "," <<
+			nRoutesEvicted_stale << "," << nRoutesEvicted_bound << "," << nRoutesRejected_hops << "," <<
+			nRoutesRejected_quality << "," << nRoutesRejected_rank << "," << nRoutesRejected_length << endl;
+}
+
+void RntpStrategy::logMemory() {
+	size_t nBytes_sentDataIDs = 0;
+	for (auto iter = transportStates_all.begin(); iter != transportStates_all.end(); ++iter) {
+		for (auto iter2 = iter->second->sentDataIDsPerNextHop.begin(); iter2 != iter->second->sentDataIDsPerNextHop.end(); ++iter2) {
+			nBytes_sentDataIDs += iter2->second.getMemoryUsage();
+		}
+	}
+	auto log = RntpUtils::getLogOthers();
+	*log << this->nodeInfo->nodeID << "," << Simulator::Now() << ",Memory," << transportStates_all.size() << "," <<
+			sendCapStatePool.countInUse() << "," << sendCapStatePool.countHighWater() << "," << sendCapStatePool.getMemoryUsage() << "," <<
+			interestBroadcastInfoPool.countInUse() << "," << interestBroadcastInfoPool.countHighWater() << "," <<
+			interestBroadcastInfoPool.getMemoryUsage() << "," << nBytes_sentDataIDs << endl;
+}
+
+void RntpStrategy::logTimers() {
+	auto log = RntpUtils::getLogOthers();
+	*log << this->nodeInfo->nodeID << "," << Simulator::Now() << ",Timers," << timerWheel.nTimersScheduled << "," <<
+			timerWheel.nTimersCancelled << "," << timerWheel.nTimersFired << "," << timerWheel.nTickEvents << "," << timerWheel.nTickEventsScheduled << "," <<
+			timerWheel.countPending() << "," << timerWheel.nTimersPending_highWater << endl;
+}
+
+void RntpStrategy::logOpportunisticForwarding() {
+	auto log = RntpUtils::getLogOthers();
+	*log << this->nodeInfo->nodeID << "," << Simulator::Now() << ",OpportunisticForwarding," << nForwardsDeferred << "," <<
+			nForwardsSuppressed << endl;
+}
 
-void RntpStrategy::dumpRoute(uint32_t consumerNodeID, string producerPrefix) {
+void RntpStrategy::logRetransmissionTimeouts() {
+	auto log = RntpUtils::getLogOthers();
+	for (auto iter = rtoPerNeighbor.begin(); iter != rtoPerNeighbor.end(); ++iter) {
+		*log << this->nodeInfo->nodeID << "," << Simulator::Now() << ",Rto," << iter->first << "," << iter->second.nSamples << "," <<
+				iter->second.rtt_smooth.GetSeconds() << "," << iter->second.rtt_var.GetSeconds() << "," << iter->second.rto.GetSeconds() << endl;
+	}
+}
+
+void RntpStrategy::logCapsuleCache() {
+	auto log = RntpUtils::getLogOthers();
+	*log << this->nodeInfo->nodeID << "," << Simulator::Now() << ",CapsuleCache," << capsuleCache.countElements() << "," <<
+			capsuleCache.getCapacity() << "," << capsuleCache.nInserted << "," << capsuleCache.nEvicted << "," <<
+			capsuleCache.nHits << "," << capsuleCache.nMisses << endl;
+}
+
+void RntpStrategy::dumpRoute(uint32_t consumerNodeID, uint32_t producerPrefixID) {
 	cout << "---------------- DUMP ROUTE (curNodeID: " << this->nodeInfo->nodeID << ", consumerNodeID: " << consumerNodeID <<
-			", producerPrefix: " << producerPrefix << ") -----------------" << endl;
-	for (route_table::iterator iter = routes_all.begin(); iter != routes_all.end(); ++iter) {
-		RoutesPerPair* routesPerPair = *iter;
-		if (routesPerPair->consumerNodeID == consumerNodeID && routesPerPair->producerPrefix == producerPrefix) {
-			for (vector<Route*>::iterator iter2 = routesPerPair->routes.begin(); iter2 != routesPerPair->routes.end(); ++iter2) {
-				Route* route = *iter2;
-				cout << route->id << ", " << route->metric << ", " << route->n_hops << ", " << route->updateTime << ", route: (";
-				for (list<uint32_t>::iterator iter3 = route->nodeIDs.begin(); iter3 != route->nodeIDs.end(); ++iter3) {
-					cout << *iter3 << " ";
-				}
-				cout << "), qualities: (";
-				for (list<double>::iterator iter3 = route->channelQualities.begin();
-										iter3 != route->channelQualities.end(); ++iter3) {
-					cout << *iter3 << " ";
-				}
-				cout << ")" << endl;
+			", producerPrefix: " << prefixInterner.getPrefix(producerPrefixID) << ") -----------------" << endl;
+	RoutesPerPair* routesPerPair = findRoutesPerPair(consumerNodeID, producerPrefixID);
+	if (routesPerPair != NULL) {
+		refreshRouteMetrics(routesPerPair);
+		for (vector<Route*>::iterator iter2 = routesPerPair->routes.begin(); iter2 != routesPerPair->routes.end(); ++iter2) {
+			Route* route = *iter2;
+			cout << route->id << ", " << route->metric << ", " << route->n_hops << ", " << route->updateTime << ", route: (";
+			const uint32_t* nodeIDs = routesPerPair->store.getNodeIDs(route->slot);
+			for (uint32_t i = 0; i < routesPerPair->store.getNNodes(route->slot); ++i) {
+				cout << nodeIDs[i] << " ";
+			}
+			cout << "), qualities: (";
+			for (Link* link : route->links) {
+				cout << link->quality << " ";
 			}
-			break;
+			cout << ")" << endl;
 		}
 	}
 	cout << "----------------------------------------------------------------" << endl;
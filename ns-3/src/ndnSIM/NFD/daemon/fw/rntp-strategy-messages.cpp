@@ -63,9 +63,9 @@ shared_ptr<Interest> RntpStrategy::constructInterest(string pitPrefixStr, uint32
 shared_ptr<Data> RntpStrategy::constructCapsule(CapsuleInfo* info, list<uint32_t>& nodeIDs, const Data& origData, uint32_t nHops) {
 	stringstream ss;
 	if (nodeIDs.size() == 0) {
-		ss << info->prefix << "/Capsule/" << info->dataID;
+		ss << prefixInterner.getPrefix(info->prefixID) << "/Capsule/" << info->dataID;
 	} else {
-		ss << info->prefix << "/Capsule/" << info->dataID << "/" << info->nonce << "/" << info->transHopNodeID;
+		ss << prefixInterner.getPrefix(info->prefixID) << "/Capsule/" << info->dataID << "/" << info->nonce << "/" << info->transHopNodeID;
 		bool isFirst = true;
 		for (auto iter = nodeIDs.begin(); iter != nodeIDs.end(); ++iter) {
 			ss << (isFirst ? "/" : "-") << *iter;
@@ -88,7 +88,7 @@ shared_ptr<Data> RntpStrategy::constructCapsule(CapsuleInfo* info, list<uint32_t
 
 shared_ptr<Data> RntpStrategy::constructCapsuleACK(CapsuleACKInfo& info) {
 	stringstream ss;
-	ss << info.prefix << "/CapsuleAck/" << info.downstreamNodeID << "/";
+	ss << prefixInterner.getPrefix(info.prefixID) << "/CapsuleAck/" << info.downstreamNodeID << "/";
 
 	bool begin = true;
 	for (uint32_t upstreamNodeID : info.upstreamNodeIDs) {
@@ -99,7 +99,8 @@ shared_ptr<Data> RntpStrategy::constructCapsuleACK(CapsuleACKInfo& info) {
 
 	size_t n = info.dataIDsReceived.size();
 	size_t nBufBytes = sizeof(uint32_t) * n + sizeof(size_t);
-	uint8_t* bufBytes = new uint8_t[nBufBytes];
+	shared_ptr<::ndn::Buffer> buf = std::make_shared<::ndn::Buffer>(nBufBytes);
+	uint8_t* bufBytes = buf->data();
 	size_t* nDataIdRegion = (size_t*) bufBytes;
 	nDataIdRegion[0] = n;
 	uint32_t* dataIdRegion = (uint32_t*) (bufBytes + sizeof(size_t));
@@ -111,11 +112,39 @@ shared_ptr<Data> RntpStrategy::constructCapsuleACK(CapsuleACKInfo& info) {
 
 	auto data = std::make_shared<Data>(ss.str());
 	data->setFreshnessPeriod(time::milliseconds(1000));
-	shared_ptr<::ndn::Buffer> buf = std::make_shared<::ndn::Buffer>(nBufBytes);
 	data->setContent(buf);
-	for (size_t i = 0; i < nBufBytes; ++i) {
-		(*buf)[i] = bufBytes[i];
+	StackHelper::getKeyChain().sign(*data);
+
+	return data;
+}
+
+shared_ptr<Data> RntpStrategy::constructCapsuleRepair(CapsuleRepairInfo& info) {
+	stringstream ss;
+	ss << prefixInterner.getPrefix(info.prefixID) << "/CapsuleRepair/" << info.requesterNodeID << "/";
+
+	bool begin = true;
+	for (uint32_t upstreamNodeID : info.upstreamNodeIDs) {
+		ss << (begin ? "" : "-") << upstreamNodeID;
+		begin = false;
+	}
+	ss << "/" << info.consumerNodeID;
+
+	size_t n = info.dataIDsMissing.size();
+	size_t nBufBytes = sizeof(uint32_t) * n + sizeof(size_t);
+	shared_ptr<::ndn::Buffer> buf = std::make_shared<::ndn::Buffer>(nBufBytes);
+	uint8_t* bufBytes = buf->data();
+	size_t* nDataIdRegion = (size_t*) bufBytes;
+	nDataIdRegion[0] = n;
+	uint32_t* dataIdRegion = (uint32_t*) (bufBytes + sizeof(size_t));
+	int i = 0;
+	for (list<uint32_t>::iterator iter = info.dataIDsMissing.begin(); iter != info.dataIDsMissing.end(); ++iter) {
+		dataIdRegion[i] = *iter;
+		++i;
 	}
+
+	auto data = std::make_shared<Data>(ss.str());
+	data->setFreshnessPeriod(time::milliseconds(1000));
+	data->setContent(buf);
 	StackHelper::getKeyChain().sign(*data);
 
 	return data;
@@ -123,7 +152,7 @@ shared_ptr<Data> RntpStrategy::constructCapsuleACK(CapsuleACKInfo& info) {
 
 shared_ptr<Data> RntpStrategy::constructInterestBroadcast(InterestBroadcastInfo* info) {
 	stringstream ss;
-	ss << info->producerPrefix << "/InterestBroadcast/" << info->hopCount <<
+	ss << prefixInterner.getPrefix(info->producerPrefixID) << "/InterestBroadcast/" << info->hopCount <<
 			"/" << info->consumerNodeID <<
 			"/" << info->transHopNodeID <<
 			"/" << info->nonce << "/" << (info->end ? "true" : "false");
@@ -133,8 +162,10 @@ shared_ptr<Data> RntpStrategy::constructInterestBroadcast(InterestBroadcastInfo*
 	size_t n = info->visitedNodeIDs.size();
 	size_t nNodeIdsBytes = sizeof(size_t) + sizeof(uint32_t) * n;
 	size_t nchannelQualitiesBytes = sizeof(size_t) +  sizeof(double) * (n - 1);
-	size_t allBufBytes = nNodeIdsBytes + nchannelQualitiesBytes;
-	uint8_t* bufBytes = new uint8_t[allBufBytes];
+	size_t nNodeWeightsBytes = sizeof(size_t) + sizeof(double) * info->nodeWeights.size();
+	size_t allBufBytes = nNodeIdsBytes + nchannelQualitiesBytes + nNodeWeightsBytes;
+	shared_ptr<::ndn::Buffer> buf = std::make_shared<::ndn::Buffer>(allBufBytes);
+	uint8_t* bufBytes = buf->data();
 	size_t* nNodeIdRegion = (size_t*) bufBytes;
 	nNodeIdRegion[0] = n;
 	uint32_t* nodeIdRegion = (uint32_t*) (bufBytes + sizeof(size_t));
@@ -153,13 +184,18 @@ shared_ptr<Data> RntpStrategy::constructInterestBroadcast(InterestBroadcastInfo*
 		++i;
 	}
 
+	size_t* nNodeWeightRegion = (size_t*) (bufBytes + nNodeIdsBytes + nchannelQualitiesBytes);
+	nNodeWeightRegion[0] = info->nodeWeights.size();
+	double* nodeWeightRegion = (double*) (bufBytes + nNodeIdsBytes + nchannelQualitiesBytes + sizeof(size_t));
+	i = 0;
+	for (list<double>::iterator iter = info->nodeWeights.begin(); iter != info->nodeWeights.end(); ++iter) {
+		nodeWeightRegion[i] = *iter;
+		++i;
+	}
+
 	auto data = std::make_shared<Data>(ss.str());
 	data->setFreshnessPeriod(time::milliseconds(1000));
-	shared_ptr<::ndn::Buffer> buf = std::make_shared<::ndn::Buffer>(allBufBytes);
 	data->setContent(buf);
-	for (size_t i = 0; i < allBufBytes; ++i) {
-		(*buf)[i] = bufBytes[i];
-	}
 	StackHelper::getKeyChain().sign(*data);
 
 	return data;
@@ -168,6 +204,9 @@ shared_ptr<Data> RntpStrategy::constructInterestBroadcast(InterestBroadcastInfo*
 shared_ptr<Data> RntpStrategy::constructEcho(EchoInfo* info) {
 	stringstream ss;
 	ss << nodeInfo->ndnNameSpace << "/ALL/Echo/" << info->sourceNodeID << "/" << info->seqNum;
+	if (info->hasNodeWeight) {
+		ss << "/" << info->nodeWeight;
+	}
 	string name = ss.str();
 	auto data = std::make_shared<Data>(string(ss.str()));
 	data->setFreshnessPeriod(time::seconds(10));
@@ -179,10 +218,13 @@ void RntpStrategy::extractEcho(const Data& data, EchoInfo* info) {
 	Name dataName = data.getName();
 	info->sourceNodeID = stoull(dataName.get(3).toUri(name::UriFormat::DEFAULT));
 	info->seqNum = stoull(dataName.get(4).toUri(name::UriFormat::DEFAULT));
+	info->hasNodeWeight = dataName.size() >= 6;
+	info->nodeWeight = info->hasNodeWeight ? stod(dataName.get(5).toUri(name::UriFormat::DEFAULT)) : 1.0;
 }
 
 void RntpStrategy::extractInterest(const Interest& interest, InterestInfo* info) {
 	info->prefix = interest.getName().toUri(name::UriFormat::DEFAULT);
+	info->prefixID = prefixInterner.intern(interest.getName());
 	struct RouteTagInfo routeTagInfo;
 	this->extractRouteTag(interest, &routeTagInfo);
 	info->consumerNodeID = routeTagInfo.consumerNodeID;
@@ -190,10 +232,8 @@ void RntpStrategy::extractInterest(const Interest& interest, InterestInfo* info)
 }
 
 void RntpStrategy::extractCapsuleInfo(const Data& data, CapsuleInfo* info) {
-	Name dataName = data.getName();
-	stringstream ss;
-	ss << "/" << dataName.get(0).toUri(name::UriFormat::DEFAULT) << "/" << dataName.get(1).toUri(name::UriFormat::DEFAULT);
-	info->prefix = ss.str();
+	const Name& dataName = data.getName();
+	info->prefixID = prefixInterner.intern(dataName);
 	info->dataID = stoull(dataName.get(3).toUri(name::UriFormat::DEFAULT));
 	if (dataName.size() >= 7) {
 		info->nonce = stoull(dataName.get(4).toUri(name::UriFormat::DEFAULT));
@@ -224,10 +264,8 @@ void RntpStrategy::extractCapsuleInfo(const Data& data, CapsuleInfo* info) {
 }
 
 void RntpStrategy::extractInterestBroadcastInfo(const Data& data, InterestBroadcastInfo* info) {
-	Name dataName = data.getName();
-	stringstream ss;
-	ss << "/" << dataName.get(0).toUri(name::UriFormat::DEFAULT) << "/" << dataName.get(1).toUri(name::UriFormat::DEFAULT);
-	info->producerPrefix = ss.str();
+	const Name& dataName = data.getName();
+	info->producerPrefixID = prefixInterner.intern(dataName);
 	info->hopCount = stoull(dataName.get(3).toUri(name::UriFormat::DEFAULT));
 	info->consumerNodeID = stoull(dataName.get(4).toUri(name::UriFormat::DEFAULT));
 	info->transHopNodeID = stoull(dataName.get(5).toUri(name::UriFormat::DEFAULT));
@@ -236,6 +274,7 @@ void RntpStrategy::extractInterestBroadcastInfo(const Data& data, InterestBroadc
 
 	info->visitedNodeIDs.clear();
 	info->channelQualities.clear();
+	info->nodeWeights.clear();
 
 	const Block& payload = data.getContent();
 	const uint8_t* buf = payload.value();
@@ -257,6 +296,16 @@ void RntpStrategy::extractInterestBroadcastInfo(const Data& data, InterestBroadc
 		double channelQuality = channelQualityRegion[i];
 		info->channelQualities.push_back(channelQuality);
 	}
+
+	size_t nBytes_read = sizeof(size_t) * 2 + n * sizeof(uint32_t) + nchannelQualities * sizeof(double);
+	if (payload.value_size() < nBytes_read + sizeof(size_t)) {
+		return;
+	}
+	size_t* nNodeWeightRegion = (size_t*) (buf + nBytes_read);
+	double* nodeWeightRegion = (double*) (buf + nBytes_read + sizeof(size_t));
+	for (size_t i = 0; i < nNodeWeightRegion[0]; ++i) {
+		info->nodeWeights.push_back(nodeWeightRegion[i]);
+	}
 }
 
 void RntpStrategy::extractRouteTag(const Data& data, RouteTagInfo* info) {
@@ -306,10 +355,8 @@ void RntpStrategy::extractPhyInfo(const Data& data, PhyInfo& info) {
 }
 
 void RntpStrategy::extractCapsuleACK(const Data& data, CapsuleACKInfo& info) {
-	Name dataName = data.getName();
-	stringstream ss;
-	ss << "/" << dataName.get(0).toUri(name::UriFormat::DEFAULT) << "/" << dataName.get(1).toUri(name::UriFormat::DEFAULT);
-	info.prefix = ss.str();
+	const Name& dataName = data.getName();
+	info.prefixID = prefixInterner.intern(dataName);
 	info.downstreamNodeID = stoull(dataName.get(3).toUri(name::UriFormat::DEFAULT));
 	string upstreamNodeIDs_str = dataName.get(4).toUri(name::UriFormat::DEFAULT);
 
@@ -338,6 +385,33 @@ void RntpStrategy::extractCapsuleACK(const Data& data, CapsuleACKInfo& info) {
 	}
 }
 
+void RntpStrategy::extractCapsuleRepair(const Data& data, CapsuleRepairInfo& info) {
+	const Name& dataName = data.getName();
+	info.prefixID = prefixInterner.intern(dataName);
+	info.requesterNodeID = stoull(dataName.get(3).toUri(name::UriFormat::DEFAULT));
+	string upstreamNodeIDs_str = dataName.get(4).toUri(name::UriFormat::DEFAULT);
+
+	char* str = const_cast<char*>(upstreamNodeIDs_str.c_str());
+	char* splitted = strtok(str, "-");
+	while (splitted != NULL) {
+		info.upstreamNodeIDs.push_back(stoull(splitted));
+		splitted = strtok(NULL, "-");
+	}
+	info.consumerNodeID = stoull(dataName.get(5).toUri(name::UriFormat::DEFAULT));
+	info.dataIDsMissing.clear();
+
+	const Block& payload = data.getContent();
+	const uint8_t* buf = payload.value();
+
+	size_t* nDataIdRegion = (size_t*) buf;
+	uint32_t* dataIdRegion = (uint32_t*) (buf + sizeof(size_t));
+	size_t n = nDataIdRegion[0];
+
+	for (size_t i = 0; i < n; ++i) {
+		info.dataIDsMissing.push_back(dataIdRegion[i]);
+	}
+}
+
 
 void RntpStrategy::writeRouteTag(const RouteTagInfo& info, Data& data) {
 	uint64_t tagValue = ((uint64_t) info.consumerNodeID << 32) | (uint64_t) info.nextHopNodeID;
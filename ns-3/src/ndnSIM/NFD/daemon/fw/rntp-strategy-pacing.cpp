@@ -0,0 +1,110 @@
+/*
+ * This work is licensed under CC BY-NC-SA 4.0
+ * (https://creativecommons.org/licenses/by-nc-sa/4.0/).
+ * Copyright (c) 2025 Boyang Zhou
+ *
+ * This file is a part of "Subpath-Aware Reliable Transport Control Protocol (SART) for Wireless Multihop Networks"
+ * (https://github.com/zhouby-zjl/sart/).
+ * Written by Boyang Zhou (zhouby@zhejianglab.com / zby_zju@163.com)
+ *
+ */
+
+#include "ns3/simulator.h"
+#include "rntp-strategy.hpp"
+
+using namespace std;
+using namespace ns3;
+
+namespace nfd {
+namespace fw {
+
+// With pacing, a node releases one capsule at a time from its send queues and waits for the
+// channel to clear before the next, instead of bursting a whole window into the MAC.
+unordered_set<uint32_t> RntpStrategy::sendCapsulesPaced(TransportStates* ts) {
+	unordered_set<uint32_t> dataIDsSent;
+	if (!pacingEvent.IsRunning() && Simulator::Now() >= pacingNextTime) {
+		size_t nBytes = 0;
+		dataIDsSent = sendReadyCapsules(ts, 1, &nBytes);
+		if (dataIDsSent.size() > 0) {
+			pacingNextTime = Simulator::Now() + getPacingInterval(ts, nBytes);
+		}
+	}
+	enqueuePacedFlow(ts);
+	schedulePacingEvent();
+	return dataIDsSent;
+}
+
+// serves the waiting flows round robin, one capsule per firing
+void RntpStrategy::onPacingTimer() {
+	while (pacedFlows.size() > 0) {
+		uint64_t flowKey = pacedFlows.front();
+		pacedFlows.pop_front();
+		pacedFlowKeys.erase(flowKey);
+
+		auto iter = transportStates_all.find(flowKey);
+		if (iter == transportStates_all.end()) {
+			continue;
+		}
+		TransportStates* ts = iter->second;
+		size_t nElements = ts->capSendQueue.countElements();
+		size_t nBytes = 0;
+		if (sendReadyCapsules(ts, 1, &nBytes).size() > 0) {
+			pacingNextTime = Simulator::Now() + getPacingInterval(ts, nBytes);
+			enqueuePacedFlow(ts);
+			break;
+		}
+		// a capsule dropped without taking the channel gives the flow another go; with its windows
+		// full, the flow rejoins when an ACK comes back
+		if (ts->capSendQueue.countElements() < nElements) {
+			enqueuePacedFlow(ts);
+		}
+	}
+	schedulePacingEvent();
+}
+
+void RntpStrategy::enqueuePacedFlow(TransportStates* ts) {
+	if (ts->capSendQueue.countElements() == 0) {
+		return;
+	}
+	uint64_t flowKey = getFlowKey(ts->prefixID, ts->consumerID);
+	if (pacedFlowKeys.insert(flowKey).second) {
+		pacedFlows.push_back(flowKey);
+	}
+}
+
+void RntpStrategy::schedulePacingEvent() {
+	if (pacedFlows.size() == 0 || pacingEvent.IsRunning()) {
+		return;
+	}
+	ns3::Time delay = pacingNextTime - Simulator::Now();
+	pacingEvent = Simulator::Schedule(delay.IsStrictlyPositive() ? delay : Seconds(0), &RntpStrategy::onPacingTimer, this);
+}
+
+// The airtime of the capsule is spent again by each hop forwarding it within interference range,
+// so releases are spaced by that many airtimes; once ACKs come back, the release rate also stays
+// within a gain of the rate at which they arrive.
+ns3::Time RntpStrategy::getPacingInterval(TransportStates* ts, size_t nBytes) {
+	double airtime = this->nodeInfo->pacingFrameOverhead.GetSeconds() + nBytes * 8.0 / this->nodeInfo->pacingPhyRate;
+	double interval = airtime * this->nodeInfo->pacingHopsSharingChannel;
+	if (ts->ackInterval_smooth > 0 && ts->ackInterval_smooth / this->nodeInfo->pacingGain > interval) {
+		interval = ts->ackInterval_smooth / this->nodeInfo->pacingGain;
+	}
+	return Seconds(interval);
+}
+
+// gaps longer than the per-hop timeout are idle periods rather than the delivery rate
+void RntpStrategy::updateAckInterval(TransportStates* ts) {
+	ns3::Time now = Simulator::Now();
+	if (!ts->lastAckTime.IsZero() && now - ts->lastAckTime < this->nodeInfo->capsulePerHopTimeout) {
+		double sample = (now - ts->lastAckTime).GetSeconds();
+		if (ts->ackInterval_smooth == 0) {
+			ts->ackInterval_smooth = sample;
+		} else {
+			ts->ackInterval_smooth = (1 - PACING_ACK_INTERVAL_ALPHA) * ts->ackInterval_smooth + PACING_ACK_INTERVAL_ALPHA * sample;
+		}
+	}
+	ts->lastAckTime = now;
+}
+
+}
+}
@@ -0,0 +1,63 @@
+/*
+ * This work is licensed under CC BY-NC-SA 4.0
+ * (https://creativecommons.org/licenses/by-nc-sa/4.0/).
+ * Copyright (c) 2025 Boyang Zhou
+ *
+ * This file is a part of "Subpath-Aware Reliable Transport Control Protocol (SART) for Wireless Multihop Networks"
+ * (https://github.com/zhouby-zjl/sart/).
+ * Written by Boyang Zhou (zhouby@zhejianglab.com / zby_zju@163.com)
+ *
+ */
+
+#include "ns3/ndnSIM/ndn-cxx/name.hpp"
+#include "rntp-strategy.hpp"
+
+#include <sstream>
+
+using namespace std;
+using namespace ns3;
+
+namespace nfd {
+namespace fw {
+
+// a prefix is the first two components of a name, e.g. /<namespace>/<producer>
+#define PREFIX_N_COMPONENTS		2
+
+uint32_t PrefixInterner::intern(const Name& name) {
+	for (uint32_t i = 0; i < names.size(); ++i) {
+		if (name.size() >= PREFIX_N_COMPONENTS &&
+				name.compare(0, PREFIX_N_COMPONENTS, names[i]) == 0) {
+			return i;
+		}
+	}
+
+	stringstream ss;
+	ss << "/" << name.get(0).toUri(name::UriFormat::DEFAULT) << "/" << name.get(1).toUri(name::UriFormat::DEFAULT);
+	uint32_t prefixID = names.size();
+	names.push_back(name.getPrefix(PREFIX_N_COMPONENTS));
+	prefixes.push_back(ss.str());
+	prefixIDs[ss.str()] = prefixID;
+	return prefixID;
+}
+
+uint32_t PrefixInterner::intern(const string& prefix) {
+	auto iter = prefixIDs.find(prefix);
+	if (iter != prefixIDs.end()) {
+		return iter->second;
+	}
+	// the same prefix may be spelled differently, so it is resolved by its components
+	uint32_t prefixID = intern(Name(prefix));
+	prefixIDs[prefix] = prefixID;
+	return prefixID;
+}
+
+const string& PrefixInterner::getPrefix(uint32_t prefixID) {
+	return prefixes[prefixID];
+}
+
+size_t PrefixInterner::countPrefixes() {
+	return names.size();
+}
+
+}
+}
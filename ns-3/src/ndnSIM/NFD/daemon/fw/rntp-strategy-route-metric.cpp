@@ -0,0 +1,96 @@
+/*
+ * This work is licensed under CC BY-NC-SA 4.0
+ * (https://creativecommons.org/licenses/by-nc-sa/4.0/).
+ * Copyright (c) 2025 Boyang Zhou
+ *
+ * This file is a part of "Subpath-Aware Reliable Transport Control Protocol (SART) for Wireless Multihop Networks"
+ * (https://github.com/zhouby-zjl/sart/).
+ * Written by Boyang Zhou (zhouby@zhejianglab.com / zby_zju@163.com)
+ *
+ */
+
+#include "ns3/simulator.h"
+#include "rntp-strategy.hpp"
+
+#include <cmath>
+
+using namespace std;
+using namespace ns3;
+
+namespace nfd {
+namespace fw {
+
+// The factor a link contributes to the route metric: its quality and the weight of the relay it
+// leads to, each raised to its weight. The route store takes the square root of the geometric mean
+// of these factors along a route, and applies the hop penalty to the route as a whole, as a
+// per-link penalty would be averaged away. With the default weights, the metric is the square root
+// of the geometric mean of the link qualities.
+double RntpStrategy::getLinkWeight(uint32_t toNodeID, double quality) {
+	if (quality <= QUALITY_BROKEN) {
+		return QUALITY_BROKEN;
+	}
+	double weight = pow(max(quality, QUALITY_MIN_POSITIVE), this->nodeInfo->routeMetricQualityWeight);
+	// this node is on every route of its table, so its own weight would not tell them apart
+	if (toNodeID != this->nodeInfo->nodeID) {
+		auto iter = nodeWeights_all.find(toNodeID);
+		if (iter != nodeWeights_all.end()) {
+			weight *= iter->second;
+		}
+	}
+	return weight;
+}
+
+double RntpStrategy::getLinkWeight(Link* link) {
+	return getLinkWeight(link->toNodeID, link->quality);
+}
+
+bool RntpStrategy::isNodeWeightAdvertised() {
+	return this->nodeInfo->routeMetricEnergyWeight > 0 || this->nodeInfo->routeMetricQueueWeight > 0;
+}
+
+// The residual energy of this node and the room left in its capsule queues, raised to their weights
+double RntpStrategy::getNodeWeight() {
+	double weight = 1.0;
+	if (this->nodeInfo->routeMetricEnergyWeight > 0 && !this->nodeInfo->residualEnergyFraction.IsNull()) {
+		double energy = max(this->nodeInfo->residualEnergyFraction(), 0.0);
+		weight *= pow(energy, this->nodeInfo->routeMetricEnergyWeight);
+	}
+	if (this->nodeInfo->routeMetricQueueWeight > 0 && this->nodeInfo->routeMetricQueueCapacity > 0) {
+		size_t nQueued = 0;
+		for (auto iter = transportStates_all.begin(); iter != transportStates_all.end(); ++iter) {
+			nQueued += iter->second->capSendQueue.countElements();
+		}
+		double occupancy = min((double) nQueued / this->nodeInfo->routeMetricQueueCapacity, 1.0);
+		weight *= pow(1.0 - occupancy, this->nodeInfo->routeMetricQueueWeight);
+	}
+	return weight;
+}
+
+void RntpStrategy::learnNodeWeights(InterestBroadcastInfo& info) {
+	if (info.nodeWeights.size() != info.visitedNodeIDs.size()) {
+		return;
+	}
+	auto iter_weights = info.nodeWeights.begin();
+	for (auto iter = info.visitedNodeIDs.begin(); iter != info.visitedNodeIDs.end(); ++iter, ++iter_weights) {
+		if (*iter != this->nodeInfo->nodeID) {
+			setNodeWeight(*iter, *iter_weights);
+		}
+	}
+}
+
+void RntpStrategy::setNodeWeight(uint32_t nodeID, double weight) {
+	auto iter = nodeWeights_all.find(nodeID);
+	if (iter != nodeWeights_all.end() && fabs(weight - iter->second) <= NODE_WEIGHT_MIN_CHANGE * iter->second) {
+		return;
+	}
+	nodeWeights_all[nodeID] = weight;
+	auto iter_links = linksByToNodeID.find(nodeID);
+	if (iter_links != linksByToNodeID.end()) {
+		for (Link* link : iter_links->second) {
+			applyLinkWeight(link);
+		}
+	}
+}
+
+}
+}
@@ -0,0 +1,207 @@
+/*
+ * This work is licensed under CC BY-NC-SA 4.0
+ * (https://creativecommons.org/licenses/by-nc-sa/4.0/).
+ * Copyright (c) 2025 Boyang Zhou
+ *
+ * This file is a part of "Subpath-Aware Reliable Transport Control Protocol (SART) for Wireless Multihop Networks"
+ * (https://github.com/zhouby-zjl/sart/).
+ * Written by Boyang Zhou (zhouby@zhejianglab.com / zby_zju@163.com)
+ *
+ */
+
+#include "rntp-strategy.hpp"
+
+#include <cmath>
+#include <limits>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+namespace nfd {
+namespace fw {
+
+// number of routes processed per step of the metric kernel; capacities are kept
+// a multiple of it so that the kernel never reads past the end of a column
+#define ROUTE_STORE_LANES		8
+
+RouteStore::RouteStore() : capacity(0), nRoutes(0), nLinksMax(0) {
+}
+
+uint32_t RouteStore::addRoute(list<uint32_t>& nodeIDs_route) {
+	if (nRoutes == capacity) {
+		reserve(capacity == 0 ? ROUTE_STORE_LANES : capacity * 2);
+	}
+	uint32_t slot = nRoutes++;
+	uint32_t n = 0;
+	for (auto iter = nodeIDs_route.begin(); iter != nodeIDs_route.end() && n < ROUTE_MAX_NODES; ++iter, ++n) {
+		nodeIDs[slot * ROUTE_MAX_NODES + n] = *iter;
+	}
+	nNodes[slot] = n;
+	for (uint32_t hop = 0; hop < ROUTE_MAX_LINKS; ++hop) {
+		logQualities[hop * capacity + slot] = 0.0f;
+	}
+	if (n > 1 && n - 1 > nLinksMax) {
+		nLinksMax = n - 1;
+	}
+	return slot;
+}
+
+// moves the last route into the freed slot, so the caller has to move it likewise
+void RouteStore::removeRoute(uint32_t slot) {
+	uint32_t slot_last = --nRoutes;
+	if (slot != slot_last) {
+		for (uint32_t i = 0; i < ROUTE_MAX_NODES; ++i) {
+			nodeIDs[slot * ROUTE_MAX_NODES + i] = nodeIDs[slot_last * ROUTE_MAX_NODES + i];
+		}
+		nNodes[slot] = nNodes[slot_last];
+		metrics[slot] = metrics[slot_last];
+		for (uint32_t hop = 0; hop < ROUTE_MAX_LINKS; ++hop) {
+			logQualities[hop * capacity + slot] = logQualities[hop * capacity + slot_last];
+		}
+	}
+	nNodes[slot_last] = 0;
+	for (uint32_t hop = 0; hop < ROUTE_MAX_LINKS; ++hop) {
+		logQualities[hop * capacity + slot_last] = 0.0f;
+	}
+}
+
+void RouteStore::reserve(uint32_t capacity_new) {
+	nodeIDs.resize((size_t) capacity_new * ROUTE_MAX_NODES, 0);
+	nNodes.resize(capacity_new, 0);
+	metrics.resize(capacity_new, 0.0f);
+
+	// columns are hop-major, so growing the capacity moves every column
+	vector<float> logQualities_new((size_t) capacity_new * ROUTE_MAX_LINKS, 0.0f);
+	for (uint32_t hop = 0; hop < ROUTE_MAX_LINKS; ++hop) {
+		for (uint32_t slot = 0; slot < nRoutes; ++slot) {
+			logQualities_new[hop * capacity_new + slot] = logQualities[hop * capacity + slot];
+		}
+	}
+	logQualities.swap(logQualities_new);
+	capacity = capacity_new;
+}
+
+const uint32_t* RouteStore::getNodeIDs(uint32_t slot) {
+	return &nodeIDs[slot * ROUTE_MAX_NODES];
+}
+
+uint32_t RouteStore::getNNodes(uint32_t slot) {
+	return nNodes[slot];
+}
+
+bool RouteStore::isRouteEqual(uint32_t slot, list<uint32_t>& nodeIDs_route) {
+	if (nodeIDs_route.size() != nNodes[slot]) {
+		return false;
+	}
+	const uint32_t* row = getNodeIDs(slot);
+	uint32_t i = 0;
+	for (auto iter = nodeIDs_route.begin(); iter != nodeIDs_route.end(); ++iter, ++i) {
+		if (row[i] != *iter) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool RouteStore::containsNode(uint32_t slot, uint32_t nodeID) {
+	const uint32_t* row = getNodeIDs(slot);
+	for (uint32_t i = 0; i < nNodes[slot]; ++i) {
+		if (row[i] == nodeID) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void RouteStore::setLinkQuality(uint32_t slot, uint32_t hop, double quality) {
+	logQualities[hop * capacity + slot] = toLogQuality(quality);
+}
+
+float RouteStore::toLogQuality(double quality) {
+	if (quality <= QUALITY_BROKEN) {
+		return -numeric_limits<float>::infinity();
+	}
+	return (float) log(quality > QUALITY_MIN_POSITIVE ? quality : QUALITY_MIN_POSITIVE);
+}
+
+// The log-qualities of the k links are averaged over 2k, which makes the metric the square root of
+// their geometric mean, and thus blind to the route length; the hop penalty then scales it by
+// exp(-hopWeight) per link. A route with a broken link gets -1.
+float RouteStore::toMetric(float logQualitySum, uint32_t nNodes, double hopWeight) {
+	uint32_t k = nNodes > 1 ? nNodes - 1 : 0;
+	if (logQualitySum == -numeric_limits<float>::infinity()) {
+		return -1.0f;
+	}
+	return k == 0 ? 1.0f : expf(logQualitySum / (float) (2 * k) - (float) (hopWeight * k));
+}
+
+// Sums the log-qualities in hop order with the same float additions as the kernel, so that a
+// route not yet stored gets exactly the metric it would be given once stored.
+float RouteStore::computeMetric(list<double>& qualities, double hopWeight) {
+	float sum = 0.0f;
+	for (double quality : qualities) {
+		sum += toLogQuality(quality);
+	}
+	return toMetric(sum, qualities.size() + 1, hopWeight);
+}
+
+void RouteStore::computeMetrics(double hopWeight) {
+	uint32_t nLanes = (nRoutes + ROUTE_STORE_LANES - 1) / ROUTE_STORE_LANES * ROUTE_STORE_LANES;
+	float* sums = metrics.data();
+	const float* cols = logQualities.data();
+
+	// the columns beyond the length of a route are zero, and a broken link is -inf,
+	// so summing all columns gives the log-product of each route, or -inf if broken
+#if defined(__AVX__)
+	for (uint32_t slot = 0; slot < nLanes; slot += 8) {
+		__m256 acc = _mm256_setzero_ps();
+		for (uint32_t hop = 0; hop < nLinksMax; ++hop) {
+			acc = _mm256_add_ps(acc, _mm256_loadu_ps(cols + hop * capacity + slot));
+		}
+		_mm256_storeu_ps(sums + slot, acc);
+	}
+#elif defined(__SSE2__)
+	for (uint32_t slot = 0; slot < nLanes; slot += 4) {
+		__m128 acc = _mm_setzero_ps();
+		for (uint32_t hop = 0; hop < nLinksMax; ++hop) {
+			acc = _mm_add_ps(acc, _mm_loadu_ps(cols + hop * capacity + slot));
+		}
+		_mm_storeu_ps(sums + slot, acc);
+	}
+#else
+	for (uint32_t slot = 0; slot < nLanes; ++slot) {
+		sums[slot] = 0.0f;
+	}
+	for (uint32_t hop = 0; hop < nLinksMax; ++hop) {
+		const float* col = cols + hop * capacity;
+		for (uint32_t slot = 0; slot < nLanes; ++slot) {
+			sums[slot] += col[slot];
+		}
+	}
+#endif
+
+	for (uint32_t slot = 0; slot < nRoutes; ++slot) {
+		metrics[slot] = toMetric(sums[slot], nNodes[slot], hopWeight);
+	}
+}
+
+double RouteStore::getMetric(uint32_t slot) {
+	return metrics[slot];
+}
+
+size_t RouteStore::countRoutes() {
+	return nRoutes;
+}
+
+size_t RouteStore::getMemoryUsage() {
+	return nodeIDs.capacity() * sizeof(uint32_t) + nNodes.capacity() * sizeof(uint8_t) +
+			logQualities.capacity() * sizeof(float) + metrics.capacity() * sizeof(float);
+}
+
+}
+}
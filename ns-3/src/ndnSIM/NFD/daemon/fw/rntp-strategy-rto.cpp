@@ -0,0 +1,60 @@
+/*
+ * This work is licensed under CC BY-NC-SA 4.0
+ * (https://creativecommons.org/licenses/by-nc-sa/4.0/).
+ * Copyright (c) 2025 Boyang Zhou
+ *
+ * This file is a part of "Subpath-Aware Reliable Transport Control Protocol (SART) for Wireless Multihop Networks"
+ * (https://github.com/zhouby-zjl/sart/).
+ * Written by Boyang Zhou (zhouby@zhejianglab.com / zby_zju@163.com)
+ *
+ */
+
+#include "ns3/simulator.h"
+#include "rntp-strategy.hpp"
+
+#include <cmath>
+
+using namespace std;
+using namespace ns3;
+
+namespace nfd {
+namespace fw {
+
+// SRTT and RTTVAR per neighbor from RFC 6298, fed with per-hop ACK RTTs of capsules sent once
+void RntpStrategy::updateRetransmissionTimeout(uint32_t neighborID, ns3::Time rtt) {
+	RtoEstimator& e = rtoPerNeighbor[neighborID];
+	if (e.nSamples == 0) {
+		e.rtt_smooth = rtt;
+		e.rtt_var = Seconds(rtt.GetSeconds() / 2);
+	} else {
+		double delta = fabs(e.rtt_smooth.GetSeconds() - rtt.GetSeconds());
+		e.rtt_var = Seconds((1 - RTO_BETA) * e.rtt_var.GetSeconds() + RTO_BETA * delta);
+		e.rtt_smooth = Seconds((1 - RTO_ALPHA) * e.rtt_smooth.GetSeconds() + RTO_ALPHA * rtt.GetSeconds());
+	}
+	++e.nSamples;
+	double rto = e.rtt_smooth.GetSeconds() + max(RTO_CLOCK_GRANULARITY_IN_SECS, RTO_K * e.rtt_var.GetSeconds());
+	e.rto = Seconds(min(max(rto, this->nodeInfo->rtoMin.GetSeconds()), this->nodeInfo->rtoMax.GetSeconds()));
+}
+
+// The timeout of a capsule's sendTimes-th transmission towards the next hop: the neighbor's RTO,
+// doubled for every retransmission and clamped; the fixed per-hop timeout until the neighbor is sampled.
+ns3::Time RntpStrategy::getRetransmissionTimeout(int nextHopID, uint32_t sendTimes) {
+	if (!this->nodeInfo->adaptiveRtoEnabled) {
+		return this->nodeInfo->capsulePerHopTimeout;
+	}
+	ns3::Time rto = this->nodeInfo->capsulePerHopTimeout;
+	if (nextHopID != -1) {
+		auto iter = rtoPerNeighbor.find(nextHopID);
+		if (iter != rtoPerNeighbor.end() && iter->second.nSamples > 0) {
+			rto = iter->second.rto;
+		}
+	}
+	double timeout = rto.GetSeconds();
+	for (uint32_t i = 1; i < sendTimes && timeout < this->nodeInfo->rtoMax.GetSeconds(); ++i) {
+		timeout *= 2;
+	}
+	return Seconds(min(timeout, this->nodeInfo->rtoMax.GetSeconds()));
+}
+
+}
+}
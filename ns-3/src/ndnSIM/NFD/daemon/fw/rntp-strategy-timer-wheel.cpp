@@ -0,0 +1,225 @@
+/*
+ * This work is licensed under CC BY-NC-SA 4.0
+ * (https://creativecommons.org/licenses/by-nc-sa/4.0/).
+ * Copyright (c) 2025 Boyang Zhou
+ *
+ * This file is a part of "Subpath-Aware Reliable Transport Control Protocol (SART) for Wireless Multihop Networks"
+ * (https://github.com/zhouby-zjl/sart/).
+ * Written by Boyang Zhou (zhouby@zhejianglab.com / zby_zju@163.com)
+ *
+ */
+
+#include "ns3/simulator.h"
+#include "rntp-strategy.hpp"
+
+using namespace std;
+using namespace ns3;
+
+namespace nfd {
+namespace fw {
+
+#define TIMER_WHEEL_SLOT_MASK		(TIMER_WHEEL_SLOTS - 1)
+
+// number of ticks spanned by one slot of the given level
+static inline uint64_t getSlotSpan(uint32_t level) {
+	return (uint64_t) 1 << (TIMER_WHEEL_SLOT_BITS * level);
+}
+
+TimerWheel::TimerWheel() : nTimersScheduled(0), nTimersCancelled(0), nTimersFired(0), nTickEvents(0), nTickEventsScheduled(0),
+		nTimersPending_highWater(0), tick_ns(1000000), tick_cur(0), tick_scheduled(TIMER_WHEEL_NONE), id_next(1) {
+	for (uint32_t level = 0; level < TIMER_WHEEL_LEVELS; ++level) {
+		for (uint32_t slot = 0; slot < TIMER_WHEEL_SLOTS; ++slot) {
+			slots[level][slot] = NULL;
+		}
+	}
+}
+
+TimerWheel::~TimerWheel() {
+	Simulator::Cancel(tickEvent);
+	for (auto iter = entriesByID.begin(); iter != entriesByID.end(); ++iter) {
+		entryPool.release(iter->second);
+	}
+}
+
+void TimerWheel::setTick(ns3::Time tick) {
+	if (tick.GetNanoSeconds() > 0) {
+		tick_ns = tick.GetNanoSeconds();
+	}
+}
+
+uint64_t TimerWheel::getCurrentTick() {
+	return Simulator::Now().GetNanoSeconds() / tick_ns;
+}
+
+// returns a non-zero timer ID; the callback runs at the first tick at or after the delay
+uint64_t TimerWheel::schedule(ns3::Time delay, std::function<void()> callback) {
+	if (entriesByID.empty()) {
+		tick_cur = getCurrentTick();
+	}
+	int64_t expiry_ns = Simulator::Now().GetNanoSeconds() + (delay.GetNanoSeconds() > 0 ? delay.GetNanoSeconds() : 0);
+	uint64_t expiryTick = (expiry_ns + tick_ns - 1) / tick_ns;
+
+	TimerWheelEntry* entry = entryPool.acquire();
+	entry->id = id_next++;
+	entry->expiryTick = expiryTick > tick_cur ? expiryTick : tick_cur + 1;
+	entry->callback = callback;
+	place(entry);
+	entriesByID[entry->id] = entry;
+
+	++nTimersScheduled;
+	if (entriesByID.size() > nTimersPending_highWater) {
+		nTimersPending_highWater = entriesByID.size();
+	}
+
+	// the entry is due, or cascades towards level 0, at the start of its slot
+	uint64_t wakeTick = entry->level == 0 ? entry->expiryTick : entry->expiryTick & ~(getSlotSpan(entry->level) - 1);
+	if (wakeTick <= tick_cur) {
+		wakeTick = tick_cur + 1;
+	}
+	if (wakeTick < tick_scheduled) {
+		scheduleTickEvent(wakeTick);
+	}
+	return entry->id;
+}
+
+void TimerWheel::cancel(uint64_t timerID) {
+	auto iter = entriesByID.find(timerID);
+	if (iter == entriesByID.end()) {
+		return;
+	}
+	unlink(iter->second);
+	entryPool.release(iter->second);
+	entriesByID.erase(iter);
+	++nTimersCancelled;
+}
+
+bool TimerWheel::isPending(uint64_t timerID) {
+	return entriesByID.find(timerID) != entriesByID.end();
+}
+
+size_t TimerWheel::countPending() {
+	return entriesByID.size();
+}
+
+void TimerWheel::place(TimerWheelEntry* entry) {
+	uint64_t delta = entry->expiryTick - tick_cur;
+	uint64_t expiryTick = entry->expiryTick;
+	uint32_t level = 0;
+	while (level < TIMER_WHEEL_LEVELS - 1 && delta >= getSlotSpan(level + 1)) {
+		++level;
+	}
+	if (delta >= getSlotSpan(TIMER_WHEEL_LEVELS)) {
+		// beyond the top level: parked at its farthest slot and placed again when cascaded
+		expiryTick = tick_cur + getSlotSpan(TIMER_WHEEL_LEVELS) - 1;
+	}
+	entry->level = level;
+	entry->slot = (expiryTick >> (TIMER_WHEEL_SLOT_BITS * level)) & TIMER_WHEEL_SLOT_MASK;
+
+	TimerWheelEntry*& head = slots[level][entry->slot];
+	entry->prev = NULL;
+	entry->next = head;
+	if (head != NULL) {
+		head->prev = entry;
+	}
+	head = entry;
+}
+
+void TimerWheel::unlink(TimerWheelEntry* entry) {
+	if (entry->prev != NULL) {
+		entry->prev->next = entry->next;
+	} else {
+		slots[entry->level][entry->slot] = entry->next;
+	}
+	if (entry->next != NULL) {
+		entry->next->prev = entry->prev;
+	}
+	entry->prev = entry->next = NULL;
+}
+
+void TimerWheel::cascade(uint32_t level, uint64_t tick) {
+	uint32_t slot = (tick >> (TIMER_WHEEL_SLOT_BITS * level)) & TIMER_WHEEL_SLOT_MASK;
+	TimerWheelEntry* entry = slots[level][slot];
+	slots[level][slot] = NULL;
+	while (entry != NULL) {
+		TimerWheelEntry* next = entry->next;
+		place(entry);
+		entry = next;
+	}
+}
+
+// whether reaching the tick moves timers down from a coarser level
+bool TimerWheel::isCascading(uint64_t tick) {
+	for (uint32_t level = 1; level < TIMER_WHEEL_LEVELS; ++level) {
+		if ((tick & (getSlotSpan(level) - 1)) != 0) {
+			break;
+		}
+		if (slots[level][(tick >> (TIMER_WHEEL_SLOT_BITS * level)) & TIMER_WHEEL_SLOT_MASK] != NULL) {
+			return true;
+		}
+	}
+	return false;
+}
+
+uint64_t TimerWheel::findNextTick() {
+	if (entriesByID.empty()) {
+		return TIMER_WHEEL_NONE;
+	}
+	for (uint64_t tick = tick_cur + 1; tick <= tick_cur + TIMER_WHEEL_SLOTS; ++tick) {
+		if (isCascading(tick) || slots[0][tick & TIMER_WHEEL_SLOT_MASK] != NULL) {
+			return tick;
+		}
+	}
+	// level 0 is empty, so sleep until the next slot boundary that cascades
+	uint64_t tick = (tick_cur + TIMER_WHEEL_SLOTS) & ~(uint64_t) TIMER_WHEEL_SLOT_MASK;
+	while (!isCascading(tick)) {
+		tick += TIMER_WHEEL_SLOTS;
+	}
+	return tick;
+}
+
+void TimerWheel::scheduleTickEvent(uint64_t tick) {
+	Simulator::Cancel(tickEvent);
+	tick_scheduled = tick;
+	if (tick == TIMER_WHEEL_NONE) {
+		return;
+	}
+	++nTickEventsScheduled;
+	int64_t delay_ns = (int64_t) (tick * tick_ns) - Simulator::Now().GetNanoSeconds();
+	tickEvent = Simulator::Schedule(NanoSeconds(delay_ns > 0 ? delay_ns : 0), &TimerWheel::onTick, this);
+}
+
+void TimerWheel::onTick() {
+	++nTickEvents;
+	// timers scheduled by the callbacks below leave the tick event to the end of this one
+	tick_scheduled = 0;
+	uint64_t tick_now = getCurrentTick();
+	while (tick_cur < tick_now && !entriesByID.empty()) {
+		++tick_cur;
+		for (uint32_t level = 1; level < TIMER_WHEEL_LEVELS; ++level) {
+			if ((tick_cur & (getSlotSpan(level) - 1)) != 0) {
+				break;
+			}
+			cascade(level, tick_cur);
+		}
+
+		TimerWheelEntry*& head = slots[0][tick_cur & TIMER_WHEEL_SLOT_MASK];
+		while (head != NULL) {
+			TimerWheelEntry* entry = head;
+			unlink(entry);
+			entriesByID.erase(entry->id);
+			std::function<void()> callback;
+			callback.swap(entry->callback);
+			entryPool.release(entry);
+			++nTimersFired;
+			// may schedule or cancel timers, though never into the slot being drained
+			callback();
+		}
+	}
+	if (entriesByID.empty()) {
+		tick_cur = tick_now;
+	}
+	scheduleTickEvent(findNextTick());
+}
+
+}
+}
@@ -44,6 +44,14 @@ using namespace ns3::ndn;
 using namespace ::ndn;
 
 #define CHANNEL_QUALITY_MAX 100000000000000.0
+// floor of the delivery rate weighting a striped route, so that a lossy route can recover
+#define STRIPE_MIN_DELIVERY_RATE 0.05
+
+static const name::Component OPERATION_INTEREST_BROADCAST("InterestBroadcast");
+static const name::Component OPERATION_CAPSULE("Capsule");
+static const name::Component OPERATION_CAPSULE_ACK("CapsuleAck");
+static const name::Component OPERATION_ECHO("Echo");
+static const name::Component OPERATION_CAPSULE_REPAIR("CapsuleRepair");
 
 namespace nfd {
 namespace fw {
@@ -54,6 +62,20 @@ NFD_REGISTER_STRATEGY(RntpStrategy);
 unordered_map<int, unordered_map<string, int>*> RntpStrategy::performance_res;
 Ptr<ns3::UniformRandomVariable> RntpStrategy::rand;
 bool RntpStrategy::enableLog_msgs;
+uint64_t RntpStrategy::nCapsuleRetransmissions = 0;
+uint64_t RntpStrategy::nEchoesSent = 0;
+uint64_t RntpStrategy::nEchoesSuppressed = 0;
+uint64_t RntpStrategy::nLinksBrokenBySilence = 0;
+double RntpStrategy::secsSilentBeforeBroken_total = 0;
+uint64_t RntpStrategy::nInterestBroadcastsSent = 0;
+uint64_t RntpStrategy::nInterestBroadcastsSuppressed = 0;
+uint64_t RntpStrategy::nInterestBroadcastsSkipped = 0;
+uint64_t RntpStrategy::nNodesReached = 0;
+double RntpStrategy::secsAsleep_total = 0;
+uint64_t RntpStrategy::nCapsuleRepairsRequested = 0;
+uint64_t RntpStrategy::nCapsuleRepairHits = 0;
+uint64_t RntpStrategy::nCapsuleRepairMisses = 0;
+uint64_t RntpStrategy::nCapsuleRepairHopsSaved = 0;
 
 void initializeRntpStrategyRand() {
 	RntpStrategy::rand = ns3::CreateObject<ns3::UniformRandomVariable>();
@@ -70,18 +92,72 @@ RntpStrategy::RntpStrategy(Forwarder& forwarder, const Name& name) : Strategy(fo
 	is_face_found = false;
 	channelQualityUpdate_seqno_cur = 0;
 	echo_seqnum = 0;
+	echoInterval = this->nodeInfo->echoPeriod;
 	route_id_cur = 0;
+	nRoutes_total = 0;
+	nRoutes_highWater = 0;
+	nRoutesEvicted_cap = 0;
+	nRoutesEvicted_idle = 0;
+	nRoutesEvicted_stale = 0;
+	nRoutesEvicted_bound = 0;
+	nRoutesRejected_hops = 0;
+	nRoutesRejected_length = 0;
+	nRoutesRejected_quality = 0;
+	nRoutesRejected_rank = 0;
+	nForwardsDeferred = 0;
+	nForwardsSuppressed = 0;
+	if (this->nodeInfo->capsuleRepairEnabled) {
+		capsuleCache.setCapacity(this->nodeInfo->cache_maxSize);
+	}
 
 	Time delayTime_echo = Seconds(rand->GetValue(0.000001, this->nodeInfo->echoPeriod.GetSeconds()));
 	Time delayTime_CQUpdate = Seconds(rand->GetValue(0.000001, this->nodeInfo->channelQualityUpdatePeriod.GetSeconds()));
 
 	sendEchoEvent = Simulator::Schedule(delayTime_echo, &RntpStrategy::sendEchoInPeriodical, this);
+	isRadioAsleep = false;
+	if (this->nodeInfo->dutyCycleEnabled) {
+		dutyCycleEvent = Simulator::Schedule(getNextDutyCycleSlot() - Simulator::Now(), &RntpStrategy::onDutyCycleSlot, this);
+	}
+	timerWheel.setTick(this->nodeInfo->timerWheelTick);
+	ageRoutesEvent = Simulator::Schedule(this->nodeInfo->routeAgingPeriod, &RntpStrategy::ageRoutes, this);
 	underPreparationToSendCQUpdate = false;
-	congestionControl = new RntpCongestionControl();
+	congestionControl = RntpCongestionControl::create(this->nodeInfo->congestionControlAlgorithm);
+	linkEstimator = RntpLinkEstimator::create(this->nodeInfo->linkEstimatorName);
 }
 
 RntpStrategy::~RntpStrategy() {
 	logRoutes();
+	logRouteTableStats();
+	logMemory();
+	logTimers();
+	logOpportunisticForwarding();
+	logRetransmissionTimeouts();
+	logCapsuleCache();
+
+	Simulator::Cancel(sendEchoEvent);
+	Simulator::Cancel(ageRoutesEvent);
+	Simulator::Cancel(dutyCycleEvent);
+	Simulator::Cancel(sleepEvent);
+	if (isRadioAsleep) {
+		secsAsleep_total += (Simulator::Now() - sleepStartTime).GetSeconds();
+	}
+	Simulator::Cancel(pacingEvent);
+	for (auto iter = pendingInterestBroadcasts.begin(); iter != pendingInterestBroadcasts.end(); ++iter) {
+		Simulator::Cancel(iter->second.sendEvent);
+	}
+	for (auto iter = transportStates_all.begin(); iter != transportStates_all.end(); ++iter) {
+		releaseTransportStates(iter->second);
+	}
+	transportStates_all.clear();
+	while (!routes_all.empty()) {
+		removeRoutesPerPair(routes_all.begin()->second);
+	}
+	for (auto iter = channelQualities.begin(); iter != channelQualities.end(); ++iter) {
+		delete iter->second.liveness;
+	}
+	channelQualities.clear();
+	delete congestionControl;
+	delete linkEstimator;
 }
 
 const Name& RntpStrategy::getStrategyName() {
@@ -105,10 +181,41 @@ void RntpStrategy::initializeFaces() {
 	is_face_found = true;
 }
 
-string RntpStrategy::hashPrefixAndConsumerID(string prefix, uint32_t consumerID) {
-	stringstream ss;
-	ss << prefix << "|" << consumerID;
-	return ss.str();
+uint64_t RntpStrategy::getFlowKey(uint32_t prefixID, uint32_t consumerID) {
+	return (uint64_t) prefixID << 32 | (uint64_t) consumerID;
+}
+
+TransportStates* RntpStrategy::createTransportStates(uint32_t prefixID, uint32_t consumerID) {
+	TransportStates* tranStates = new TransportStates;
+	tranStates->prefixID = prefixID;
+	tranStates->consumerID = consumerID;
+	InterestBroadcastStates* rreqStates = new InterestBroadcastStates;
+	rreqStates->recvTime = Simulator::Now();
+	tranStates->receivedInterestBroadcasts = rreqStates;
+	tranStates->capSendQueue.setNodeID(this->nodeInfo->nodeID);
+	tranStates->ackInterval_smooth = 0;
+	tranStates->isDataIDSeen = false;
+	tranStates->dataID_highest = 0;
+	tranStates->isRepairTimerSet = false;
+	tranStates->isRouteAwaited = false;
+	transportStates_all[getFlowKey(prefixID, consumerID)] = tranStates;
+	return tranStates;
+}
+
+// The flow's timers are cancelled with its state, so that no retransmission, deferred forward or
+// repair fires for a terminated flow, nor on the flow's states if they are created again.
+void RntpStrategy::releaseTransportStates(TransportStates* ts) {
+	while (!ts->sendCapStates.empty()) {
+		releaseSendCapState(ts, ts->sendCapStates.begin()->first);
+	}
+	for (auto iter = ts->pendingForwards.begin(); iter != ts->pendingForwards.end(); ++iter) {
+		timerWheel.cancel(iter->second);
+	}
+	if (ts->isRepairTimerSet) {
+		timerWheel.cancel(ts->repairTimerID);
+	}
+	delete ts->receivedInterestBroadcasts;
+	delete ts;
 }
 
 void RntpStrategy::afterReceiveInterest(const FaceEndpoint& ingress, const Interest& interest,
@@ -129,29 +236,26 @@ void RntpStrategy::afterReceiveInterest(const FaceEndpoint& ingress, const Inter
 
 	if (hasPendingOutRecords(*pitEntry)) return;
 
-	if (this->findPrefix(info.prefix) >= 0 && face_app != NULL) {
+	if (this->findPrefix(info.prefixID) >= 0 && face_app != NULL) {
 		this->sendInterest(pitEntry, FaceEndpoint(*face_app, 0), interest);
 
 	} else if (info.consumerNodeID == 0xffffffff) {
-		string h = hashPrefixAndConsumerID(info.prefix, this->nodeInfo->nodeID);
+		uint64_t h = getFlowKey(info.prefixID, this->nodeInfo->nodeID);
 		if (transportStates_all.find(h) != transportStates_all.end()) {
 			return;
 		} else {
-			TransportStates* tranStates = new TransportStates;
-			tranStates->prefix = info.prefix;
-			InterestBroadcastStates* rreqStates = new InterestBroadcastStates;
-			rreqStates->recvTime = Simulator::Now();
-			tranStates->receivedInterestBroadcasts = rreqStates;
-			tranStates->capSendQueue.setNodeID(this->nodeInfo->nodeID);
-			congestionControl->init(tranStates, nodeInfo);
-			transportStates_all[h] = tranStates;
+			TransportStates* tranStates = createTransportStates(info.prefixID, this->nodeInfo->nodeID);
 
 			list<uint32_t> visitedNodeIDs;
 			visitedNodeIDs.push_back(this->nodeInfo->nodeID);
 			list<double> channelQualities;
+			list<double> nodeWeights;
+			if (isNodeWeightAdvertised()) {
+				nodeWeights.push_back(getNodeWeight());
+			}
 
-			propagateInterests(rreqStates, info.prefix, visitedNodeIDs, channelQualities,
-								this->nodeInfo->nodeID, 0, false);
+			propagateInterests(tranStates->receivedInterestBroadcasts, info.prefixID, visitedNodeIDs, channelQualities,
+								nodeWeights, this->nodeInfo->nodeID, 0, false);
 		}
 	}
 
@@ -162,22 +266,23 @@ void RntpStrategy::afterReceiveData(const shared_ptr<pit::Entry>& pitEntry,
 		const FaceEndpoint& ingress, const Data& data) {
 	initializeFaces();
 
-	Name dataName = data.getName();
+	const Name& dataName = data.getName();
 	//cout << "%%%%%%%>> " << dataName << " @ NodeID: " << nodeInfo->nodeID << ", time: " << Simulator::Now().GetSeconds() << endl;
 	int nDataNameComponents = pitEntry->getName().size();
-	string operationStr = dataName.get(nDataNameComponents).toUri(name::UriFormat::DEFAULT);
-	string pitPrefixStr = pitEntry->getName().toUri(name::UriFormat::DEFAULT);
+	const name::Component& operation = dataName.get(nDataNameComponents);
 
-	if (operationStr.compare("InterestBroadcast") == 0) {
+	if (operation == OPERATION_INTEREST_BROADCAST) {
 		onReceiveInterestBroadcast(ingress, data);
-	} else if (operationStr.compare("Capsule") == 0) {
+	} else if (operation == OPERATION_CAPSULE) {
 		onReceiveCapsule(ingress, data);
-	} else if (operationStr.compare("CapsuleAck") == 0) {
+	} else if (operation == OPERATION_CAPSULE_ACK) {
 		onReceiveCapsuleAck(ingress, data);
-	} else if (operationStr.compare("Echo") == 0) {
+	} else if (operation == OPERATION_ECHO) {
 		onReceiveEcho(ingress, data);
+	} else if (operation == OPERATION_CAPSULE_REPAIR) {
+		onReceiveCapsuleRepair(ingress, data);
 	} else {
-		cout << "===> unknown operationStr: " << operationStr << endl;
+		cout << "===> unknown operationStr: " << operation.toUri(name::UriFormat::DEFAULT) << endl;
 	}
 }
 
@@ -185,20 +290,22 @@ void RntpStrategy::afterReceiveData(const shared_ptr<pit::Entry>& pitEntry,
 void RntpStrategy::afterReceiveNonPitData(const FaceEndpoint& ingress, const Data& data) {
 	initializeFaces();
 
-	Name dataName = data.getName();
-	string operationStr = dataName.get(2).toUri(name::UriFormat::DEFAULT);
+	const Name& dataName = data.getName();
+	const name::Component& operation = dataName.get(2);
 	//cout << "NonPitData >> " << dataName << " @ NodeID: " << nodeInfo->nodeID << ", time: " << Simulator::Now().GetSeconds() << endl;
 
-	if (operationStr.compare("InterestBroadcast") == 0) {
+	if (operation == OPERATION_INTEREST_BROADCAST) {
 		onReceiveInterestBroadcast(ingress, data);
-	} else if (operationStr.compare("Capsule") == 0) {
+	} else if (operation == OPERATION_CAPSULE) {
 		onReceiveCapsule(ingress, data);
-	} else if (operationStr.compare("CapsuleAck") == 0) {
+	} else if (operation == OPERATION_CAPSULE_ACK) {
 		onReceiveCapsuleAck(ingress, data);
-	} else if (operationStr.compare("Echo") == 0) {
+	} else if (operation == OPERATION_ECHO) {
 		onReceiveEcho(ingress, data);
+	} else if (operation == OPERATION_CAPSULE_REPAIR) {
+		onReceiveCapsuleRepair(ingress, data);
 	} else {
-		cout << "===> unknown operationStr: " << operationStr << endl;
+		cout << "===> unknown operationStr: " << operation.toUri(name::UriFormat::DEFAULT) << endl;
 	}
 }
 
@@ -210,31 +317,35 @@ void RntpStrategy::onReceiveInterestBroadcast(const FaceEndpoint& ingress, const
 
 	this->logMsgInterestBroadcast(true, info, &phyInfo);
 
-	double curQuality = phyInfo.snr;
-
-	updateChannelQuality(info.transHopNodeID, curQuality);
+	updateChannelQuality(info.transHopNodeID, phyInfo.snr, false);
+	double curQuality = linkEstimator->getAdvertisedQuality(channelQualities[info.transHopNodeID].estimate, phyInfo.snr);
 
 	if (info.end == true) { // for terminating transport states
 		if (std::find(info.visitedNodeIDs.begin(), info.visitedNodeIDs.end(), this->nodeInfo->nodeID) != info.visitedNodeIDs.end()) {
 			return;
 		}
 
-		string h = this->hashPrefixAndConsumerID(info.producerPrefix, info.consumerNodeID);
+		uint64_t h = this->getFlowKey(info.producerPrefixID, info.consumerNodeID);
 		auto iter = transportStates_all.find(h);
 		if (iter != transportStates_all.end()) {
-			transportStates_all.erase(h);
+			TransportStates* ts = iter->second;
+			transportStates_all.erase(iter);
+			releaseTransportStates(ts);
 
 			cout << "[Node " << this->nodeInfo->nodeID << ", " << Simulator::Now().GetMicroSeconds() << " us] terminate transport states with"
-					" producerPrefix: "  <<  info.producerPrefix <<
+					" producerPrefix: "  <<  prefixInterner.getPrefix(info.producerPrefixID) <<
 					", consumerNodeID: " << info.consumerNodeID << endl;
 
 			if (info.visitedNodeIDs.size() > 0) {
 				info.channelQualities.push_back(curQuality);
 			}
 			info.visitedNodeIDs.push_back(this->nodeInfo->nodeID);
+			if (isNodeWeightAdvertised()) {
+				info.nodeWeights.push_back(getNodeWeight());
+			}
 
-			this->propagateInterests(NULL, info.producerPrefix, info.visitedNodeIDs, info.channelQualities,
-									info.consumerNodeID, 0, true);
+			this->propagateInterests(NULL, info.producerPrefixID, info.visitedNodeIDs, info.channelQualities,
+									info.nodeWeights, info.consumerNodeID, 0, true);
 		}
 		return;
 	}
@@ -242,6 +353,7 @@ void RntpStrategy::onReceiveInterestBroadcast(const FaceEndpoint& ingress, const
 	if (info.consumerNodeID == this->nodeInfo->nodeID) {
 		return;
 	}
+	holdRadioAwake();
 
 	uint32_t hopCount = info.hopCount + 1;
 
@@ -249,7 +361,7 @@ void RntpStrategy::onReceiveInterestBroadcast(const FaceEndpoint& ingress, const
 	if (enableLog_msgs) {
 		cout << "[Node " << nodeInfo->nodeID << ", " << Simulator::Now().GetNanoSeconds() << " ns] receives an InterestBroadcast with"
 				" hopCount: "  << info.hopCount <<
-				", producerPrefix: "  <<  info.producerPrefix <<
+				", producerPrefix: "  <<  prefixInterner.getPrefix(info.producerPrefixID) <<
 				", consumerNodeID: " << info.consumerNodeID <<
 				", transHopNodeID: " << info.transHopNodeID <<
 				", SNR: " << RatioToDb(phyInfo.snr) << ", RSSI: " << WToDbm(phyInfo.rssi) <<
@@ -262,65 +374,71 @@ void RntpStrategy::onReceiveInterestBroadcast(const FaceEndpoint& ingress, const
 		cout << ", end: " << info.end << endl;
 	}
 
-	int32_t prefixIdx = findPrefix(info.producerPrefix);
+	learnNodeWeights(info);
+
+	int32_t prefixIdx = findPrefix(info.producerPrefixID);
 
 	if (prefixIdx >= 0) {
 		info.visitedNodeIDs.push_back(this->nodeInfo->nodeID);
 		info.channelQualities.push_back(curQuality);
 
-		this->addRoute(info.producerPrefix, info.consumerNodeID, hopCount,
+		if (!isDiscoveredRouteAdmitted(info.producerPrefixID, info.consumerNodeID, hopCount, info.channelQualities)) {
+			return;
+		}
+		this->addRoute(info.producerPrefixID, info.consumerNodeID, hopCount,
 						info.visitedNodeIDs, info.channelQualities);
 
-		string h = this->hashPrefixAndConsumerID(info.producerPrefix, info.consumerNodeID);
+		uint64_t h = this->getFlowKey(info.producerPrefixID, info.consumerNodeID);
 		auto iter = transportStates_all.find(h);
 		if (iter == transportStates_all.end()) {
-			TransportStates* tranStates = new TransportStates;
-			tranStates->prefix = info.producerPrefix;
-			InterestBroadcastStates* rreqStates = new InterestBroadcastStates;
-			rreqStates->recvTime = Simulator::Now();
-			tranStates->receivedInterestBroadcasts = rreqStates;
-			tranStates->capSendQueue.setNodeID(this->nodeInfo->nodeID);
-			congestionControl->init(tranStates, nodeInfo);
-			transportStates_all[h] = tranStates;
+			createTransportStates(info.producerPrefixID, info.consumerNodeID);
+			++nNodesReached;
 		} else {
 			return;
 		}
 
 		if (face_app != NULL) {
-			shared_ptr<Interest> interestOut = this->constructInterest(info.producerPrefix, info.consumerNodeID, -1);
+			shared_ptr<Interest> interestOut = this->constructInterest(prefixInterner.getPrefix(info.producerPrefixID),
+																		info.consumerNodeID, -1);
 			FaceEndpoint egress(*this->face_app, 0);
 			egress.face.sendInterest(*interestOut, egress.endpoint);
 			this->logMsgInterestBroadcast(false, info, NULL);
 		}
 
 	} else {
+		overhearInterestBroadcast(info);
 		if (std::find(info.visitedNodeIDs.begin(), info.visitedNodeIDs.end(), this->nodeInfo->nodeID) != info.visitedNodeIDs.end()) {
 			return;
 		}
 
 		info.visitedNodeIDs.push_back(this->nodeInfo->nodeID);
 		info.channelQualities.push_back(curQuality);
+		if (isNodeWeightAdvertised()) {
+			info.nodeWeights.push_back(getNodeWeight());
+		}
 
-		this->addRoute(info.producerPrefix, info.consumerNodeID, hopCount,
+		// a rejected copy neither adds a route nor opens the flow here, so a later and
+		// better copy can still be relayed
+		if (!isDiscoveredRouteAdmitted(info.producerPrefixID, info.consumerNodeID, hopCount, info.channelQualities)) {
+			return;
+		}
+		this->addRoute(info.producerPrefixID, info.consumerNodeID, hopCount,
 						info.visitedNodeIDs, info.channelQualities);
 
-		string h = this->hashPrefixAndConsumerID(info.producerPrefix, info.consumerNodeID);
+		uint64_t h = this->getFlowKey(info.producerPrefixID, info.consumerNodeID);
 
 		auto iter = transportStates_all.find(h);
 		if (iter == transportStates_all.end()) {
-			InterestBroadcastStates* rreqStates = NULL;
-
-			TransportStates* tranStates = new TransportStates;
-			tranStates->prefix = info.producerPrefix;
-			rreqStates = new InterestBroadcastStates;
-			rreqStates->recvTime = Simulator::Now();
-			tranStates->receivedInterestBroadcasts = rreqStates;
-			tranStates->capSendQueue.setNodeID(this->nodeInfo->nodeID);
-			congestionControl->init(tranStates, nodeInfo);
-			transportStates_all[h] = tranStates;
-
-			this->propagateInterests(rreqStates, info.producerPrefix, info.visitedNodeIDs, info.channelQualities,
-									info.consumerNodeID, hopCount, false);
+			TransportStates* tranStates = createTransportStates(info.producerPrefixID, info.consumerNodeID);
+			++nNodesReached;
+
+			if (shouldRebroadcastInterest()) {
+				this->propagateInterests(tranStates->receivedInterestBroadcasts, info.producerPrefixID,
+										info.visitedNodeIDs, info.channelQualities, info.nodeWeights,
+										info.consumerNodeID, hopCount, false);
+			} else {
+				++nInterestBroadcastsSkipped;
+			}
 		}
 
 	}
@@ -367,16 +485,12 @@ int RntpStrategy::checkCapsuleArrivalDirection(CapsuleInfo& capInfo) {
 		return CAP_ARRIVAL_FROM_DOWNSTREAM;
 
 	} else if (nodeIdx_cur == -1 && nodeIdx_trans != -1) {
-		for (route_table::iterator iter = routes_all.begin(); iter != routes_all.end(); ++iter) {
-			RoutesPerPair* routesPerPair = *iter;
-			if (routesPerPair->consumerNodeID == capInfo.consumerNodeID && routesPerPair->producerPrefix == capInfo.prefix) {
-				for (vector<Route*>::iterator iter2 = routesPerPair->routes.begin(); iter2 != routesPerPair->routes.end(); ++iter2) {
-					Route* route = *iter2;
-					for (auto iter3 = route->nodeIDs.begin(); iter3 != route->nodeIDs.end(); ++iter3) {
-						if (*iter3 == capInfo.transHopNodeID) {
-							return CAP_ARRIVAL_FROM_DOWNSTREAM;
-						}
-					}
+		RoutesPerPair* routesPerPair = findRoutesPerPair(capInfo.consumerNodeID, capInfo.prefixID);
+		if (routesPerPair != NULL) {
+			for (vector<Route*>::iterator iter2 = routesPerPair->routes.begin(); iter2 != routesPerPair->routes.end(); ++iter2) {
+				Route* route = *iter2;
+				if (routesPerPair->store.containsNode(route->slot, capInfo.transHopNodeID)) {
+					return CAP_ARRIVAL_FROM_DOWNSTREAM;
 				}
 			}
 		}
@@ -388,8 +502,17 @@ int RntpStrategy::checkCapsuleArrivalDirection(CapsuleInfo& capInfo) {
 
 }
 
-uint64_t RntpStrategy::hashDataIDAndNextHopID(uint32_t dataID, uint32_t nextHopID) {
-	return  (uint64_t) nextHopID << 32 | (uint64_t) dataID ;
+bool RntpStrategy::isDataIDSent(TransportStates* ts, uint32_t dataID, uint32_t nextHopID) {
+	auto iter = ts->sentDataIDsPerNextHop.find(nextHopID);
+	return iter != ts->sentDataIDsPerNextHop.end() && iter->second.contains(dataID);
+}
+
+void RntpStrategy::markDataIDSent(TransportStates* ts, uint32_t dataID, uint32_t nextHopID) {
+	auto iter = ts->sentDataIDsPerNextHop.find(nextHopID);
+	if (iter == ts->sentDataIDsPerNextHop.end()) {
+		iter = ts->sentDataIDsPerNextHop.emplace(nextHopID, DataIDWindow(this->nodeInfo->dataIDWindowSize)).first;
+	}
+	iter->second.insert(dataID);
 }
 
 list<uint32_t> RntpStrategy::getUpstreamNodeIDsFromCapsule(list<uint32_t> nodeIDs, uint32_t transHopNodeID) {
@@ -420,6 +543,25 @@ int RntpStrategy::getNextHop(list<uint32_t>& nodeIDs) {
 	return nextHopID;
 }
 
+int RntpStrategy::getNextHop(Route* route) {
+	RouteStore& store = route->routesPerPair->store;
+	const uint32_t* nodeIDs = store.getNodeIDs(route->slot);
+	int nextHopID = -1;
+	for (uint32_t i = 0; i < store.getNNodes(route->slot); ++i) {
+		if (nodeIDs[i] == this->nodeInfo->nodeID) {
+			break;
+		}
+		nextHopID = nodeIDs[i];
+	}
+	return nextHopID;
+}
+
+list<uint32_t> RntpStrategy::getRouteNodeIDs(Route* route) {
+	RouteStore& store = route->routesPerPair->store;
+	const uint32_t* nodeIDs = store.getNodeIDs(route->slot);
+	return list<uint32_t>(nodeIDs, nodeIDs + store.getNNodes(route->slot));
+}
+
 void RntpStrategy::onReceiveCapsule(const FaceEndpoint& ingress, const Data& data) {
 	CapsuleInfo capInfo;
 	this->extractCapsuleInfo(data, &capInfo);
@@ -430,16 +572,14 @@ void RntpStrategy::onReceiveCapsule(const FaceEndpoint& ingress, const Data& dat
 	this->logMsgCapsule(true, capInfo, &phyInfo);
 
 	if (capInfo.nodeIDs.size() > 0) {
-		updateChannelQuality(capInfo.transHopNodeID, phyInfo.snr);
+		updateChannelQuality(capInfo.transHopNodeID, phyInfo.snr, true);
 	}
 
-	string h = this->hashPrefixAndConsumerID(capInfo.prefix, capInfo.consumerNodeID);
-
-	auto iter = this->transportStates_all.find(h);
+	auto iter = this->transportStates_all.find(getFlowKey(capInfo.prefixID, capInfo.consumerNodeID));
 	if (iter == this->transportStates_all.end()) {
 		return;
 	}
-	TransportStates* ts = this->transportStates_all[h];
+	TransportStates* ts = iter->second;
 
 	if (capInfo.consumerNodeID == 0xffffffff) {
 		return;
@@ -447,26 +587,26 @@ void RntpStrategy::onReceiveCapsule(const FaceEndpoint& ingress, const Data& dat
 
 	int direction = checkCapsuleArrivalDirection(capInfo);
 	if (direction == CAP_ARRIVAL_FROM_DOWNSTREAM && capInfo.consumerNodeID != this->nodeInfo->nodeID) {
+		suppressPendingForward(ts, capInfo.dataID);
 		dealWithAck(ts, capInfo.dataID, capInfo.transHopNodeID, this->nodeInfo->nodeID, 1);
 		return;
 	}
 
 	if (capInfo.consumerNodeID == this->nodeInfo->nodeID) {
 		int nextHopID = getNextHop(capInfo.nodeIDs);
-		uint64_t dn = hashDataIDAndNextHopID(capInfo.dataID, nextHopID);
 
-		if (ts->sentDataIDAndNextHops.find(dn) != ts->sentDataIDAndNextHops.end()) {
+		if (isDataIDSent(ts, capInfo.dataID, nextHopID)) {
 			list<uint32_t> dataIDsReceived;
 			dataIDsReceived.push_back(capInfo.dataID);
 			list<uint32_t> upstreamNodeIDs = this->getUpstreamNodeIDsFromCapsule(capInfo.nodeIDs, capInfo.transHopNodeID);
-			this->sendCapsuleACK(capInfo.prefix, dataIDsReceived, this->nodeInfo->nodeID,
+			this->sendCapsuleACK(capInfo.prefixID, dataIDsReceived, this->nodeInfo->nodeID,
 								upstreamNodeIDs, capInfo.transHopNodeID, capInfo.consumerNodeID);
 
 			return;
 		}
 
 		if (enableLog_msgs) {
-			cout << "[Node " << nodeInfo->nodeID << ", " << Simulator::Now().GetNanoSeconds() << " ns] receives a Capsule ($1) with prefix: " <<  capInfo.prefix << ", dataID: " << capInfo.dataID <<
+			cout << "[Node " << nodeInfo->nodeID << ", " << Simulator::Now().GetNanoSeconds() << " ns] receives a Capsule ($1) with prefix: " <<  prefixInterner.getPrefix(capInfo.prefixID) << ", dataID: " << capInfo.dataID <<
 					", consumerNodeID: " << capInfo.consumerNodeID << ", SNR: " << RatioToDb(phyInfo.snr) << ", RSSI: " << WToDbm(phyInfo.rssi)
 					<< ", nodeIDs: ";
 
@@ -481,20 +621,23 @@ void RntpStrategy::onReceiveCapsule(const FaceEndpoint& ingress, const Data& dat
 
 			FaceEndpoint egress(*this->face_app, 0);
 			egress.face.sendData(*d, egress.endpoint);
-			ts->sentDataIDAndNextHops.insert(dn);
+			markDataIDSent(ts, capInfo.dataID, nextHopID);
 
 			this->logMsgCapsule(false, capInfo, NULL);
 		}
+		if (this->nodeInfo->capsuleRepairEnabled) {
+			trackCapsuleGaps(ts, capInfo);
+		}
 
 		list<uint32_t> dataIDsReceived;
 		dataIDsReceived.push_back(capInfo.dataID);
 		list<uint32_t> upstreamNodeIDs = this->getUpstreamNodeIDsFromCapsule(capInfo.nodeIDs, capInfo.transHopNodeID);
-		this->sendCapsuleACK(capInfo.prefix, dataIDsReceived, this->nodeInfo->nodeID,
+		this->sendCapsuleACK(capInfo.prefixID, dataIDsReceived, this->nodeInfo->nodeID,
 							upstreamNodeIDs, capInfo.transHopNodeID, capInfo.consumerNodeID);
 
 	} else if (capInfo.nodeIDs.size() == 0) {
 		if (enableLog_msgs) {
-			cout << "[Node " << nodeInfo->nodeID << ", " << Simulator::Now().GetNanoSeconds() << " ns] receives a Capsule ($2) with prefix: " <<  capInfo.prefix << ", dataID: " << capInfo.dataID <<
+			cout << "[Node " << nodeInfo->nodeID << ", " << Simulator::Now().GetNanoSeconds() << " ns] receives a Capsule ($2) with prefix: " <<  prefixInterner.getPrefix(capInfo.prefixID) << ", dataID: " << capInfo.dataID <<
 					", consumerNodeID: " << capInfo.consumerNodeID << ", SNR: " << RatioToDb(phyInfo.snr) << ", RSSI: " << WToDbm(phyInfo.rssi)
 					<< ", nodeIDs: ";
 
@@ -508,7 +651,7 @@ void RntpStrategy::onReceiveCapsule(const FaceEndpoint& ingress, const Data& dat
 
 	} else if (direction == CAP_ARRIVAL_FROM_UPSTREAM) {
 		if (enableLog_msgs) {
-			cout << "[Node " << nodeInfo->nodeID << ", " << Simulator::Now().GetNanoSeconds() << " ns] receives a Capsule ($3) with prefix: " <<  capInfo.prefix << ", dataID: " << capInfo.dataID <<
+			cout << "[Node " << nodeInfo->nodeID << ", " << Simulator::Now().GetNanoSeconds() << " ns] receives a Capsule ($3) with prefix: " <<  prefixInterner.getPrefix(capInfo.prefixID) << ", dataID: " << capInfo.dataID <<
 					", consumerNodeID: " << capInfo.consumerNodeID << ", transNodeID: " << capInfo.transHopNodeID << ", SNR: " << RatioToDb(phyInfo.snr) << ", RSSI: " << WToDbm(phyInfo.rssi)
 					<< ", nodeIDs: ";
 
@@ -518,8 +661,49 @@ void RntpStrategy::onReceiveCapsule(const FaceEndpoint& ingress, const Data& dat
 			cout << endl;
 		}
 
+		if (this->nodeInfo->opportunisticForwardingEnabled) {
+			forwardOpportunistically(ts, capInfo, data);
+		} else {
+			sendCapsuleViaQueue(ts, capInfo, data, SEND_CAP_FROM_PERVIOUS_HOP);
+		}
+	}
+}
+
+// Every downstream member of the capsule's path that hears it backs off by a slot per hop it
+// is away from the consumer, so the furthest receiver forwards first and the others, hearing
+// that forward come from downstream, drop theirs.
+void RntpStrategy::forwardOpportunistically(TransportStates* ts, CapsuleInfo& capInfo, const Data& data) {
+	if (ts->pendingForwards.find(capInfo.dataID) != ts->pendingForwards.end()) {
+		return;
+	}
+	uint32_t nHopsToConsumer = 0;
+	for (auto iter = capInfo.nodeIDs.begin(); iter != capInfo.nodeIDs.end() && *iter != this->nodeInfo->nodeID; ++iter) {
+		++nHopsToConsumer;
+	}
+	if (nHopsToConsumer <= 1) {
 		sendCapsuleViaQueue(ts, capInfo, data, SEND_CAP_FROM_PERVIOUS_HOP);
+		return;
 	}
+
+	ns3::Time backoff = Seconds(this->nodeInfo->opportunisticForwardingSlot.GetSeconds() * (nHopsToConsumer - 1));
+	CapsuleInfo capInfo_fwd = capInfo;
+	uint32_t dataID = capInfo.dataID;
+	ts->pendingForwards[dataID] = timerWheel.schedule(backoff, [this, ts, capInfo_fwd, data, dataID]() mutable {
+		ts->pendingForwards.erase(dataID);
+		this->sendCapsuleViaQueue(ts, capInfo_fwd, data, SEND_CAP_FROM_PERVIOUS_HOP);
+	});
+	++nForwardsDeferred;
+}
+
+bool RntpStrategy::suppressPendingForward(TransportStates* ts, uint32_t dataID) {
+	auto iter = ts->pendingForwards.find(dataID);
+	if (iter == ts->pendingForwards.end()) {
+		return false;
+	}
+	timerWheel.cancel(iter->second);
+	ts->pendingForwards.erase(iter);
+	++nForwardsSuppressed;
+	return true;
 }
 
 int RntpStrategy::dealWithAck(TransportStates* ts, uint32_t dataID, uint32_t downstreamNodeID, uint32_t transNodeID, uint32_t reason) {
@@ -532,21 +716,53 @@ int RntpStrategy::dealWithAck(TransportStates* ts, uint32_t dataID, uint32_t dow
 		return DEAL_ACK_NO_NEED;
 	}
 
-	uint64_t dn = this->hashDataIDAndNextHopID(dataID, downstreamNodeID);
-	if (ts->sentDataIDAndNextHops.find(dn) == ts->sentDataIDAndNextHops.end()) {
-		congestionControl->onCapAckReceived(ts, nodeInfo);
+	if (!isDataIDSent(ts, dataID, downstreamNodeID)) {
+		int nextHopID = iter2->second->nextHopID;
+		// sampled only for capsules sent once, as the ACK of a retransmitted one is ambiguous
+		ns3::Time rtt = iter2->second->sendTimes == 1 ? Simulator::Now() - iter2->second->sendTime : Seconds(0);
+		congestionControl->onCapAckReceived(ts, nodeInfo, nextHopID != -1 ? nextHopID : downstreamNodeID, rtt);
+		if (rtt.IsStrictlyPositive()) {
+			updateRetransmissionTimeout(nextHopID != -1 ? nextHopID : downstreamNodeID, rtt);
+		}
+		updateLinkDelivery(nextHopID != -1 ? nextHopID : downstreamNodeID, true);
 	}
 
-	ts->sentDataIDAndNextHops.insert(dn);
+	markDataIDSent(ts, dataID, downstreamNodeID);
 
-	Simulator::Remove(iter2->second->sendEventID);
-	ts->sendCapStates.erase(dataID);
+	updateStripePath(ts, iter2->second, true);
+	updateAckInterval(ts);
+	releaseSendCapState(ts, dataID);
+	if (this->nodeInfo->capsuleRepairEnabled) {
+		cacheCapsule(ts, dataID);
+	}
 	ts->capSendQueue.removeElement(dataID);
 
 	this->sendCapsulesInQueue(ts);
 	return DEAL_ACK_DONE;
 }
 
+// the pending retransmission of the capsule is cancelled along with its state
+void RntpStrategy::releaseSendCapState(TransportStates* ts, uint32_t dataID) {
+	auto iter = ts->sendCapStates.find(dataID);
+	if (iter == ts->sendCapStates.end()) {
+		return;
+	}
+	if (iter->second != NULL) {
+		if (iter->second->isStriped) {
+			auto iter_path = ts->stripePaths.find(iter->second->stripeRouteID);
+			if (iter_path != ts->stripePaths.end() && iter_path->second.nInFlight > 0) {
+				--iter_path->second.nInFlight;
+			}
+		}
+		if (iter->second->nextHopID != -1) {
+			congestionControl->onCapReleased(ts, iter->second->nextHopID);
+		}
+		timerWheel.cancel(iter->second->sendTimerID);
+		sendCapStatePool.release(iter->second);
+	}
+	ts->sendCapStates.erase(iter);
+}
+
 void RntpStrategy::onReceiveCapsuleAck(const FaceEndpoint& ingress, const Data& data) {
 	CapsuleACKInfo ackInfo;
 	this->extractCapsuleACK(data, ackInfo);
@@ -555,7 +771,7 @@ void RntpStrategy::onReceiveCapsuleAck(const FaceEndpoint& ingress, const Data&
 
 	this->logMsgCapAck(true, ackInfo, &phyInfo);
 
-	updateChannelQuality(ackInfo.downstreamNodeID, phyInfo.snr);
+	updateChannelQuality(ackInfo.downstreamNodeID, phyInfo.snr, true);
 
 	auto iter_un = std::find(ackInfo.upstreamNodeIDs.begin(), ackInfo.upstreamNodeIDs.end(), this->nodeInfo->nodeID);
 
@@ -573,13 +789,12 @@ void RntpStrategy::onReceiveCapsuleAck(const FaceEndpoint& ingress, const Data&
 		cout << "." << endl;
 	}
 
-	string h = this->hashPrefixAndConsumerID(ackInfo.prefix, ackInfo.consumerNodeID);
-	auto iter = this->transportStates_all.find(h);
+	auto iter = this->transportStates_all.find(getFlowKey(ackInfo.prefixID, ackInfo.consumerNodeID));
 	if (iter == this->transportStates_all.end()) {
 		return;
 	}
 
-	TransportStates* ts = transportStates_all[h];
+	TransportStates* ts = iter->second;
 	uint32_t dataID = *ackInfo.dataIDsReceived.begin();
 
 	dealWithAck(ts, dataID, ackInfo.downstreamNodeID, ackInfo.transHopNodeID, 2);
@@ -600,20 +815,28 @@ void RntpStrategy::onReceiveEcho(const FaceEndpoint& ingress, const Data& data)
 				", seqNum: "  << info.seqNum << endl;
 	}
 
-	updateChannelQuality(info.sourceNodeID, phyInfo.snr);
+	auto iter = channelQualities.find(info.sourceNodeID);
+	if (iter != channelQualities.end()) {
+		linkEstimator->onEchoReceived(iter->second.estimate, info.seqNum);
+	}
+	if (info.hasNodeWeight) {
+		setNodeWeight(info.sourceNodeID, info.nodeWeight);
+	}
+	updateChannelQuality(info.sourceNodeID, phyInfo.snr, false);
 }
 
-void RntpStrategy::propagateInterests(InterestBroadcastStates* rreqStates, string producerPrefix,
-										list<uint32_t>& visitedNodeIDs, list<double>& channelQualities,
+void RntpStrategy::propagateInterests(InterestBroadcastStates* rreqStates, uint32_t producerPrefixID,
+										list<uint32_t>& visitedNodeIDs, list<double>& channelQualities, list<double>& nodeWeights,
 										uint32_t consumerNodeID, uint32_t initialHopCount, bool end) {
-	InterestBroadcastInfo* info = new InterestBroadcastInfo;
+	InterestBroadcastInfo* info = interestBroadcastInfoPool.acquire();
 	info->hopCount = initialHopCount;
-	info->producerPrefix = producerPrefix;
+	info->producerPrefixID = producerPrefixID;
 	info->consumerNodeID = consumerNodeID;
 	info->transHopNodeID = this->nodeInfo->nodeID;
 	info->nonce = 0;
 	info->visitedNodeIDs = visitedNodeIDs;
 	info->channelQualities = channelQualities;
+	info->nodeWeights = nodeWeights;
 
 	info->nonce = this->rand->GetInteger();
 	info->end = end;
@@ -624,39 +847,86 @@ void RntpStrategy::propagateInterests(InterestBroadcastStates* rreqStates, strin
 
 	double waitTime = rand->GetValue(0, this->nodeInfo->interestContentionTimeInSecs);
 
-	Simulator::Schedule(ns3::Seconds(waitTime), &RntpStrategy::propagateInterestsAsync, this, info, data, this->nodeInfo->interestSendTimes);
+	ns3::EventId sendEvent = Simulator::Schedule(ns3::Seconds(waitTime), &RntpStrategy::propagateInterestsAsync, this, info, data,
+												this->nodeInfo->interestSendTimes);
+
+	// only relays hold back, whereas the consumer's broadcast and the terminating ones always go out
+	if (this->nodeInfo->interestSuppressionEnabled && !end && initialHopCount > 0) {
+		uint64_t h = getFlowKey(producerPrefixID, consumerNodeID);
+		auto iter = pendingInterestBroadcasts.find(h);
+		if (iter != pendingInterestBroadcasts.end()) {
+			Simulator::Cancel(iter->second.sendEvent);
+			interestBroadcastInfoPool.release(iter->second.info);
+			pendingInterestBroadcasts.erase(iter);
+		}
+		PendingInterestBroadcast& pending = pendingInterestBroadcasts[h];
+		pending.info = info;
+		pending.sendEvent = sendEvent;
+		pending.hopCount = initialHopCount;
+		pending.worstQuality = getWorstChannelQuality(info->channelQualities);
+	}
+}
+
+// Gossip with a probability that keeps about interestSuppressionDegree rebroadcasters among the
+// neighbors, however dense they are.
+bool RntpStrategy::shouldRebroadcastInterest() {
+	if (!this->nodeInfo->interestSuppressionEnabled || channelQualities.size() <= this->nodeInfo->interestSuppressionDegree) {
+		return true;
+	}
+	return rand->GetValue(0, 1) < (double) this->nodeInfo->interestSuppressionDegree / channelQualities.size();
+}
+
+// The pending broadcast of the flow is dropped once interestSuppressionCopies neighbors are
+// heard sending it from no more hops and over no worse a link than this node would.
+void RntpStrategy::overhearInterestBroadcast(InterestBroadcastInfo& info) {
+	auto iter = pendingInterestBroadcasts.find(getFlowKey(info.producerPrefixID, info.consumerNodeID));
+	if (iter == pendingInterestBroadcasts.end()) {
+		return;
+	}
+	PendingInterestBroadcast& pending = iter->second;
+	if (info.hopCount > pending.hopCount || getWorstChannelQuality(info.channelQualities) < pending.worstQuality) {
+		return;
+	}
+	pending.coveringNodeIDs.insert(info.transHopNodeID);
+	if (pending.coveringNodeIDs.size() < this->nodeInfo->interestSuppressionCopies) {
+		return;
+	}
+	Simulator::Cancel(pending.sendEvent);
+	interestBroadcastInfoPool.release(pending.info);
+	pendingInterestBroadcasts.erase(iter);
+	++nInterestBroadcastsSuppressed;
 }
 
 void RntpStrategy::propagateInterestsAsync(InterestBroadcastInfo* info, shared_ptr<Data> data, uint32_t times) {
+	holdRadioAwake();
 	this->sendLltcNonPitData(*data);
+	onMsgSent();
+	++nInterestBroadcastsSent;
 
 	this->logMsgInterestBroadcast(false, *info, NULL);
 	if (enableLog_msgs) {
 		cout << "[Node " << this->nodeInfo->nodeID << ", " << Simulator::Now().GetMicroSeconds() << " us] sends a InterestBroadcast with"
 				" hopCount: "  << info->hopCount <<
-				", producerPrefix: "  <<  info->producerPrefix <<
+				", producerPrefix: "  <<  prefixInterner.getPrefix(info->producerPrefixID) <<
 				", consumerNodeID: " << info->consumerNodeID <<
 				", transHopNodeID: " << info->transHopNodeID << ", nonce: " << info->nonce << ", end: " << info->end << endl;
 	}
+	auto iter_pending = pendingInterestBroadcasts.find(getFlowKey(info->producerPrefixID, info->consumerNodeID));
+	if (iter_pending != pendingInterestBroadcasts.end() && iter_pending->second.info != info) {
+		iter_pending = pendingInterestBroadcasts.end();
+	}
 	if (times >= 2) {
 		double waitTime = rand->GetValue(0, this->nodeInfo->interestContentionTimeInSecs);
-		Simulator::Schedule(ns3::Seconds(waitTime), &RntpStrategy::propagateInterestsAsync, this, info, data, times - 1);
-	}
-}
-
-uint64_t RntpStrategy::getHash(CapsuleInfo& capInfo) {
-	int nextHopID = -1;
-	if (capInfo.nodeIDs.size() != 0) {
-		for (auto iter = capInfo.nodeIDs.begin(); iter != capInfo.nodeIDs.end(); ++iter) {
-			if (*iter == this->nodeInfo->nodeID) {
-				break;
-			}
-			nextHopID = *iter;
+		ns3::EventId sendEvent = Simulator::Schedule(ns3::Seconds(waitTime), &RntpStrategy::propagateInterestsAsync, this, info, data, times - 1);
+		if (iter_pending != pendingInterestBroadcasts.end()) {
+			iter_pending->second.sendEvent = sendEvent;
 		}
+	} else {
+		if (iter_pending != pendingInterestBroadcasts.end()) {
+			pendingInterestBroadcasts.erase(iter_pending);
+		}
+		interestBroadcastInfoPool.release(info);
 	}
-
-	uint64_t dn = hashDataIDAndNextHopID(capInfo.dataID, nextHopID);
-	return dn;
 }
 
 void RntpStrategy::sendCapsuleViaQueue(TransportStates* ts, CapsuleInfo& capInfo, const Data& data,
@@ -667,7 +937,7 @@ void RntpStrategy::sendCapsuleViaQueue(TransportStates* ts, CapsuleInfo& capInfo
 		list<uint32_t> upstreamNodeIDs = this->getUpstreamNodeIDsFromCapsule(capInfo.nodeIDs, capInfo.transHopNodeID);
 		list<uint32_t> dataIDsReceived;
 		dataIDsReceived.push_back(capInfo.dataID);
-		this->sendCapsuleACK(capInfo.prefix, dataIDsReceived, this->nodeInfo->nodeID,
+		this->sendCapsuleACK(capInfo.prefixID, dataIDsReceived, this->nodeInfo->nodeID,
 							upstreamNodeIDs, capInfo.transHopNodeID, capInfo.consumerNodeID);
 
 		return;
@@ -687,38 +957,71 @@ void RntpStrategy::sendCapsuleViaQueue(TransportStates* ts, CapsuleInfo& capInfo
 		if (upstreamNodeIDs.size() > 0) {
 			list<uint32_t> dataIDsReceived;
 			dataIDsReceived.push_back(capInfo.dataID);
-			this->sendCapsuleACK(capInfo.prefix, dataIDsReceived, this->nodeInfo->nodeID,
+			this->sendCapsuleACK(capInfo.prefixID, dataIDsReceived, this->nodeInfo->nodeID,
 								upstreamNodeIDs, capInfo.transHopNodeID, capInfo.consumerNodeID);
 		}
 	}
 }
 
 unordered_set<uint32_t> RntpStrategy::sendCapsulesInQueue(TransportStates* ts) {
+	if (this->nodeInfo->pacingEnabled) {
+		return sendCapsulesPaced(ts);
+	}
+	return sendReadyCapsules(ts, UINT32_MAX, NULL);
+}
+
+// Walks the ready capsules in order and sends, up to nMax, each one whose next hop has room in
+// its window, so that a next hop backing off does not hold up the capsules for the others.
+unordered_set<uint32_t> RntpStrategy::sendReadyCapsules(TransportStates* ts, uint32_t nMax, size_t* nBytesSent) {
 	unordered_set<uint32_t> dataIDsSent;
-	for (int i = 0; i < ts->window; ++i) {
-		if (ts->capSendQueue.countElements() > 0) {
-			CapsuleToSend* cs_send = ts->capSendQueue.getFront();
-			ts->capSendQueue.transientlyPopElement();
-
-			uint32_t transHopNodeID_prev = cs_send->capInfo.transHopNodeID;
-			cs_send->capInfo.transHopNodeID = this->nodeInfo->nodeID;
-			int r = sendCapsule(ts, cs_send->capInfo, transHopNodeID_prev, cs_send->data, cs_send->nTimesRetried,
-								cs_send->code);
-
-			if (r == SEND_CAP_NORM) {
-				dataIDsSent.insert(cs_send->capInfo.dataID);
+	uint32_t nSkipped = 0;
+	uint32_t nTried = 0;
+	CapsuleToSend* cs_send = ts->capSendQueue.getFront();
+	while (cs_send != NULL && nSkipped < SEND_QUEUE_SCAN_MAX_SKIPPED && nTried < nMax) {
+		// taken first, as sending moves the capsule out of the ready list
+		CapsuleToSend* cs_next = ts->capSendQueue.getNextReady(cs_send);
+
+		bool isStriped = false;
+		Route* route = chooseRoute(ts, cs_send->capInfo, cs_send->code, cs_send->nTimesRetried, true, &isStriped);
+		int nextHopID = route != NULL ? getNextHop(route) : -1;
+		if (route == NULL || (nextHopID != -1 && !congestionControl->isWindowAvailable(ts, nodeInfo, nextHopID))) {
+			if (route == NULL) {
+				ts->isRouteAwaited = true;
+			} else {
+				ts->nextHopsAwaited.insert(nextHopID);
 			}
+			++nSkipped;
+			cs_send = cs_next;
+			continue;
+		}
 
-		} else {
-			break;
+		uint32_t dataID = cs_send->capInfo.dataID;
+		size_t nBytes = cs_send->data.getContent().value_size();
+		ts->capSendQueue.transientlyPopElement(dataID);
+		++nTried;
+
+		uint32_t transHopNodeID_prev = cs_send->capInfo.transHopNodeID;
+		cs_send->capInfo.transHopNodeID = this->nodeInfo->nodeID;
+		int r = sendCapsule(ts, cs_send->capInfo, transHopNodeID_prev, cs_send->data, cs_send->nTimesRetried,
+							cs_send->code);
+
+		if (r == SEND_CAP_NORM) {
+			ts->nextHopsAwaited.erase(nextHopID);
+			dataIDsSent.insert(dataID);
+			if (nBytesSent != NULL) {
+				*nBytesSent += nBytes;
+			}
 		}
+		cs_send = cs_next;
 	}
 	return dataIDsSent;
 }
 
 int RntpStrategy::sendCapsule(TransportStates* ts, CapsuleInfo& capInfo, uint32_t transHopNodeID_prev,
 								const Data& data, uint32_t nTimesRetried, int code) {
-	SendCapState* tranState = new SendCapState();
+	releaseSendCapState(ts, capInfo.dataID);
+	SendCapState* tranState = sendCapStatePool.acquire();
+	tranState->nextHopID = -1;
 	tranState->sendTimes = 0;
 	ts->sendCapStates[capInfo.dataID] = tranState;
 
@@ -733,36 +1036,40 @@ int RntpStrategy::sendCapsule(TransportStates* ts, CapsuleInfo& capInfo, uint32_
 
 int RntpStrategy::sendCapsuleIterative(TransportStates* ts, CapsuleInfo& capInfo,
 										const Data& data, SendCapsuleIterParam params) {
-	SendCapState* tranState = ts->sendCapStates[capInfo.dataID];
+	auto iter_state = ts->sendCapStates.find(capInfo.dataID);
+	SendCapState* tranState = iter_state != ts->sendCapStates.end() ? iter_state->second : NULL;
 	if (tranState == NULL) {
 		ts->capSendQueue.removeElement(capInfo.dataID);
 		return SEND_CAP_CANCELED;
 	}
-	string h = this->hashPrefixAndConsumerID(capInfo.prefix, capInfo.consumerNodeID);
-	auto iter = this->transportStates_all.find(h);
+	if (tranState->sendTimes > 0) {
+		updateStripePath(ts, tranState, false);
+		if (tranState->nextHopID != -1) {
+			updateLinkDelivery(tranState->nextHopID, false);
+		}
+	}
+	auto iter = this->transportStates_all.find(getFlowKey(capInfo.prefixID, capInfo.consumerNodeID));
 	if (iter == this->transportStates_all.end()) {
-		ts->sendCapStates.erase(capInfo.dataID);
+		releaseSendCapState(ts, capInfo.dataID);
 		ts->capSendQueue.removeElement(capInfo.dataID);
 		return SEND_CAP_DUPLICATED;
 	}
-	TransportStates* ts_serv = this->transportStates_all[h];
+	TransportStates* ts_serv = iter->second;
 
-	Route* route_to_choose = this->matchRoute(capInfo.consumerNodeID, capInfo.prefix, capInfo.nodeIDs, &capInfo.nodeIDs);
-
-	if (route_to_choose == NULL) {
-		uint32_t rank = 0;
-		if (params.code == SEND_CAP_FOR_RETRYING) {
-			rank = params.nTimesRetried + 1;
-		}
-		route_to_choose = this->lookupRoute(capInfo.consumerNodeID, capInfo.prefix,
-											&capInfo.nodeIDs, rank);
-	}
+	bool isStriped = false;
+	Route* route_to_choose = chooseRoute(ts, capInfo, params.code, params.nTimesRetried, !tranState->isStriped, &isStriped);
 
 	if (route_to_choose == NULL || tranState->sendTimes == this->nodeInfo->capsuleRetryingMaxTimes) {
-		ts_serv->sendCapStates.erase(capInfo.dataID);
+		bool isRetryingExceeded = tranState->sendTimes == this->nodeInfo->capsuleRetryingMaxTimes;
+		// the next hop the capsule timed out on backs off, whether or not another route is found now
+		int nextHopID = tranState->sendTimes > 0 ? tranState->nextHopID : -1;
+		releaseSendCapState(ts_serv, capInfo.dataID);
 
 
 		CapsuleToSend* cts = ts_serv->capSendQueue.restoreElement(capInfo.dataID);
+		if (cts == NULL) {
+			return SEND_CAP_CANCELED;
+		}
 
 		if (cts->code == SEND_CAP_FOR_RETRYING) {
 			++cts->nTimesRetried;
@@ -771,35 +1078,29 @@ int RntpStrategy::sendCapsuleIterative(TransportStates* ts, CapsuleInfo& capInfo
 		}
 		cts->code = SEND_CAP_FOR_RETRYING;
 
-		int nextHopID = -1;
-		if (route_to_choose != NULL) {
-			nextHopID = this->getNextHop(route_to_choose->nodeIDs);
-		}
-
 		congestionControl->onCapAckTimeout(ts_serv, nodeInfo, nextHopID);
 
 		if (route_to_choose == NULL) {
 			return SEND_CAP_NO_ROUTE;
 		}
 
-		if (tranState->sendTimes == this->nodeInfo->capsuleRetryingMaxTimes) {
+		if (isRetryingExceeded) {
 			return SEND_CAP_EXCEED_MAX_RETRYING_TIME;
 		}
 
 	} else {
-		int nextHopID = getNextHop(route_to_choose->nodeIDs);
-		uint64_t dn = hashDataIDAndNextHopID(capInfo.dataID, nextHopID);
+		int nextHopID = getNextHop(route_to_choose);
 
-		if (ts->sentDataIDAndNextHops.find(dn) != ts->sentDataIDAndNextHops.end()) {
+		if (isDataIDSent(ts, capInfo.dataID, nextHopID)) {
 			list<uint32_t> upstreamNodeIDs = this->getUpstreamNodeIDsFromCapsule(capInfo.nodeIDs, params.transHopNodeID_prev);
 			if (upstreamNodeIDs.size() > 0) {
 				list<uint32_t> dataIDsReceived;
 				dataIDsReceived.push_back(capInfo.dataID);
-				this->sendCapsuleACK(capInfo.prefix, dataIDsReceived, this->nodeInfo->nodeID,
+				this->sendCapsuleACK(capInfo.prefixID, dataIDsReceived, this->nodeInfo->nodeID,
 									upstreamNodeIDs, capInfo.transHopNodeID, capInfo.consumerNodeID);
 			}
 
-			ts->sendCapStates.erase(capInfo.dataID);
+			releaseSendCapState(ts, capInfo.dataID);
 			ts->capSendQueue.removeElement(capInfo.dataID);
 
 			return SEND_CAP_ALREADY_SENT;
@@ -808,7 +1109,7 @@ int RntpStrategy::sendCapsuleIterative(TransportStates* ts, CapsuleInfo& capInfo
 
 	shared_ptr<Data> capOut = NULL;
 	if (route_to_choose != NULL) { // route needs to be changed
-		list<uint32_t> nodeIDs_new = route_to_choose->nodeIDs;
+		list<uint32_t> nodeIDs_new = this->getRouteNodeIDs(route_to_choose);
 
 		if (nodeIDs_new.back() == this->nodeInfo->nodeID) {
 			int n = capInfo.nodeIDs.size();
@@ -838,14 +1139,38 @@ int RntpStrategy::sendCapsuleIterative(TransportStates* ts, CapsuleInfo& capInfo
 		addDownStreamNodes(&tranState->nodeIDs_down, capInfo.nodeIDs);
 	}
 
+	if (isStriped) {
+		tranState->isStriped = true;
+		tranState->stripeRouteID = route_to_choose->id;
+		++ts->stripePaths[route_to_choose->id].nInFlight;
+	}
+
+	// a retransmission over another subpath moves the capsule to the window of its new next hop
+	int nextHopID_new = route_to_choose != NULL ? getNextHop(route_to_choose) : -1;
+	if (nextHopID_new != tranState->nextHopID) {
+		if (tranState->nextHopID != -1) {
+			congestionControl->onCapReleased(ts, tranState->nextHopID);
+		}
+		tranState->nextHopID = nextHopID_new;
+		if (nextHopID_new != -1) {
+			congestionControl->onCapSent(ts, nodeInfo, nextHopID_new);
+		}
+	}
+
+	holdRadioAwake();
 	FaceEndpoint egress(*this->face_netdev, 0);
 	egress.face.sendData(*capOut, egress.endpoint);
+	onMsgSent();
+	if (tranState->sendTimes > 0) {
+		++nCapsuleRetransmissions;
+	}
 	++tranState->sendTimes;
+	tranState->sendTime = Simulator::Now();
 
 	this->logMsgCapsule(false, capInfo, NULL);
 
 	if (enableLog_msgs) {
-		cout << "[Node " << nodeInfo->nodeID << ", " << Simulator::Now().GetNanoSeconds() << " ns] sends a Capsule with prefix: " <<  capInfo.prefix << ", dataID: " << capInfo.dataID <<
+		cout << "[Node " << nodeInfo->nodeID << ", " << Simulator::Now().GetNanoSeconds() << " ns] sends a Capsule with prefix: " <<  prefixInterner.getPrefix(capInfo.prefixID) << ", dataID: " << capInfo.dataID <<
 			", consumerNodeID: " << capInfo.consumerNodeID << ", transNodeID: " << capInfo.transHopNodeID << ", times: " << tranState->sendTimes << ", nodeIDs: ";
 
 		for (auto iter = capInfo.nodeIDs.begin(); iter != capInfo.nodeIDs.end(); ++iter) {
@@ -855,9 +1180,11 @@ int RntpStrategy::sendCapsuleIterative(TransportStates* ts, CapsuleInfo& capInfo
 	}
 
 	if (tranState->sendTimes <= this->nodeInfo->capsuleRetryingMaxTimes) {
-		ns3::Time timeout = nodeInfo->capsulePerHopTimeout;
-		tranState->sendEventID = Simulator::Schedule(timeout, &RntpStrategy::sendCapsuleIterative, this,
-										ts, capInfo, data, params);
+		ns3::Time timeout = getRetransmissionTimeout(tranState->nextHopID, tranState->sendTimes);
+		CapsuleInfo capInfo_retry = capInfo;
+		tranState->sendTimerID = timerWheel.schedule(timeout, [this, ts, capInfo_retry, data, params]() mutable {
+			this->sendCapsuleIterative(ts, capInfo_retry, data, params);
+		});
 	}
 
 	return SEND_CAP_NORM;
@@ -872,56 +1199,98 @@ void RntpStrategy::addDownStreamNodes(unordered_set<uint32_t>* A, list<uint32_t>
 	}
 }
 
-void RntpStrategy::updateChannelQuality(uint32_t fromNodeID, double quality) {
+// The silence threshold of an Echo-only neighbor is at least livenessMinSilence, that of a neighbor
+// carrying capsules or ACKs is at least as many of their mean gaps as livenessMinSilence has Echo
+// periods, i.e., it tolerates as many messages lost in a row.
+void RntpStrategy::updateChannelQuality(uint32_t fromNodeID, double quality, bool isData) {
 	double smoothed_quality = 0;
 	auto iter = channelQualities.find(fromNodeID);
 	ns3::Time msgTimeout_est = this->nodeInfo->msgTimeout;
 
 	if (iter == channelQualities.end()) {
 		ChannelQualityStates cqs;
-		cqs.quality_smooth = quality;
+		linkEstimator->init(cqs.estimate, quality);
+		cqs.quality_smooth = linkEstimator->getQuality(cqs.estimate);
 		cqs.fromNodeID = fromNodeID;
-		cqs.thQueue = new ThroughputQueue(this->nodeInfo->thQueueSize);
-		cqs.thQueue->recordPacketArrival(Simulator::Now());
+		cqs.waitMsgTimerID = 0;
+		cqs.liveness = new LivenessDetector(this->nodeInfo->livenessWindowSize, this->nodeInfo->livenessPhiThreshold,
+											this->nodeInfo->livenessMinStdDev, this->nodeInfo->echoPeriod);
+		cqs.liveness->recordPacketArrival(Simulator::Now(), isData);
 
 		channelQualities[fromNodeID] = cqs;
-		smoothed_quality = quality;
+		smoothed_quality = cqs.quality_smooth;
+		resetEchoInterval();
 
 	} else {
-		iter->second.quality_smooth = (1 - this->nodeInfo->quality_alpha) * iter->second.quality_smooth +
-						this->nodeInfo->quality_alpha * quality;
+		linkEstimator->onReceive(iter->second.estimate, this->nodeInfo, quality);
+		iter->second.quality_smooth = linkEstimator->getQuality(iter->second.estimate);
 
-		iter->second.thQueue->recordPacketArrival(Simulator::Now());
-		msgTimeout_est = iter->second.thQueue->estimateLongestPIAT(this->nodeInfo->longestPIATEstCondifentRatio,
-																	this->nodeInfo->msgTimeout);
+		iter->second.liveness->recordPacketArrival(Simulator::Now(), isData);
+		double minIntervals = this->nodeInfo->livenessMinSilence.GetSeconds() / this->nodeInfo->echoPeriod.GetSeconds();
+		msgTimeout_est = iter->second.liveness->estimateSilenceThreshold(minIntervals, this->nodeInfo->livenessMinSilence,
+																		this->nodeInfo->msgTimeout);
 
 		smoothed_quality = iter->second.quality_smooth;
-		Simulator::Cancel(iter->second.waitMsgEvent);
 	}
 
+	auto iter_link = links_all.find(hashLink(fromNodeID, this->nodeInfo->nodeID));
+	bool isRestored = iter_link != links_all.end() && iter_link->second->quality == QUALITY_BROKEN;
 	this->updateRoutesWithQuality(fromNodeID, this->nodeInfo->nodeID, smoothed_quality);
 
-	channelQualities[fromNodeID].waitMsgEvent = Simulator::Schedule(msgTimeout_est,
-											&RntpStrategy::markChannelBroken, this, fromNodeID, "message timeout");
+	// the pending timer is only replaced if the new deadline is earlier than it
+	ChannelQualityStates& cqs = channelQualities[fromNodeID];
+	cqs.waitMsgDeadline = Simulator::Now() + msgTimeout_est;
+	if (!timerWheel.isPending(cqs.waitMsgTimerID) || cqs.waitMsgTimerExpiry > cqs.waitMsgDeadline) {
+		timerWheel.cancel(cqs.waitMsgTimerID);
+		cqs.waitMsgTimerExpiry = cqs.waitMsgDeadline;
+		cqs.waitMsgTimerID = timerWheel.schedule(msgTimeout_est, [this, fromNodeID]() {
+			this->onWaitMsgTimer(fromNodeID);
+		});
+	}
 
 
 	if (iter != channelQualities.end()) {
-		for (auto iter2 = transportStates_all.begin(); iter2 != transportStates_all.end(); ++iter2) {
-			set<uint32_t> neighbors = this->getNeighboredIDsInRoutes(iter2->second->consumerID, iter2->second->prefix);
-			if (neighbors.find(fromNodeID) != neighbors.end()) {
-				this->congestionControl->onChannelWaken(iter2->second, nodeInfo, fromNodeID);
-				sendCapsulesInQueue(iter2->second);
+		auto iter_flows = flowsPerNeighbor.find(fromNodeID);
+		if (iter_flows == flowsPerNeighbor.end()) {
+			return;
+		}
+		// copied, as sending may change the routes and so the index
+		vector<uint64_t> flowKeys;
+		flowKeys.reserve(iter_flows->second.size());
+		for (auto iter2 = iter_flows->second.begin(); iter2 != iter_flows->second.end(); ++iter2) {
+			flowKeys.push_back(iter2->first);
+		}
+		for (uint64_t flowKey : flowKeys) {
+			auto iter_ts = transportStates_all.find(flowKey);
+			if (iter_ts == transportStates_all.end()) {
+				continue;
 			}
+			TransportStates* ts = iter_ts->second;
+			// there is nothing to send without queued capsules
+			if (ts->capSendQueue.countElements() == 0) {
+				continue;
+			}
+			// only capsules held back by this neighbor's window, now open, or by a route the neighbor
+			// has just restored may be sent; the scan marks them again if they are still held back
+			bool isWoken = isRestored && ts->isRouteAwaited;
+			if (ts->nextHopsAwaited.count(fromNodeID) > 0 && congestionControl->isWindowAvailable(ts, nodeInfo, fromNodeID)) {
+				isWoken = true;
+			}
+			if (!isWoken) {
+				continue;
+			}
+			ts->nextHopsAwaited.erase(fromNodeID);
+			ts->isRouteAwaited = false;
+			sendCapsulesInQueue(ts);
 		}
-
 	}
 }
 
-void RntpStrategy::sendCapsuleACK(string prefix, list<uint32_t>& dataIDsReceived,
+void RntpStrategy::sendCapsuleACK(uint32_t prefixID, list<uint32_t>& dataIDsReceived,
 								uint32_t downstreamNodeID, list<uint32_t> upstreamNodeIDs,
 								uint32_t transHopNodeID, uint32_t consumerNodeID) {
 	CapsuleACKInfo info;
-	info.prefix = prefix;
+	info.prefixID = prefixID;
 
 	info.upstreamNodeIDs = upstreamNodeIDs;
 	info.downstreamNodeID = downstreamNodeID;
@@ -930,8 +1299,10 @@ void RntpStrategy::sendCapsuleACK(string prefix, list<uint32_t>& dataIDsReceived
 	info.consumerNodeID = consumerNodeID;
 
 	shared_ptr<Data> data = this->constructCapsuleACK(info);
+	holdRadioAwake();
 	FaceEndpoint egress(*this->face_netdev, 0);
 	egress.face.sendData(*data, egress.endpoint);
+	onMsgSent();
 
 	this->logMsgCapAck(false, info, NULL);
 
@@ -956,12 +1327,37 @@ void RntpStrategy::sendCapsuleACK(string prefix, list<uint32_t>& dataIDsReceived
 }
 
 
+// With Trickle Echoes, an Echo is only sent once nothing else has been heard from this node for
+// the Echo interval, which doubles after every Echo up to echoMaxPeriod and is reset when the
+// neighborhood changes.
 void RntpStrategy::sendEchoInPeriodical() {
 	initializeFaces();
 
+	if (this->nodeInfo->echoTrickleEnabled && !lastSendTime.IsZero()) {
+		ns3::Time due = lastSendTime + echoInterval;
+		if (due > Simulator::Now()) {
+			++nEchoesSuppressed;
+			sendEchoEvent = Simulator::Schedule(due - Simulator::Now(), &RntpStrategy::sendEchoInPeriodical, this);
+			return;
+		}
+	}
+
+	// a sleeping node announces itself in its next awake window instead
+	if (!isRadioAsleep) {
+		sendEcho();
+		if (this->nodeInfo->echoTrickleEnabled) {
+			echoInterval = Seconds(min(echoInterval.GetSeconds() * 2, this->nodeInfo->echoMaxPeriod.GetSeconds()));
+		}
+	}
+	sendEchoEvent = Simulator::Schedule(echoInterval, &RntpStrategy::sendEchoInPeriodical, this);
+}
+
+void RntpStrategy::sendEcho() {
 	EchoInfo info;
 	info.sourceNodeID = this->nodeInfo->nodeID;
 	info.seqNum = echo_seqnum++;
+	info.hasNodeWeight = isNodeWeightAdvertised();
+	info.nodeWeight = info.hasNodeWeight ? getNodeWeight() : 1.0;
 	shared_ptr<Data> data = this->constructEcho(&info);
 	FaceEndpoint egress(*this->face_netdev, 0);
 	egress.face.sendData(*data, egress.endpoint);
@@ -973,7 +1369,24 @@ void RntpStrategy::sendEchoInPeriodical() {
 				<< info.sourceNodeID <<
 				", seqNum: "  << info.seqNum << endl;
 	}
-	sendEchoEvent = Simulator::Schedule(this->nodeInfo->echoPeriod, &RntpStrategy::sendEchoInPeriodical, this);
+	++nEchoesSent;
+	onMsgSent();
+}
+
+// a lost or new neighbor should hear from this node again within an Echo period, at a random
+// point of it, so that the nodes around do not all reset at once
+void RntpStrategy::resetEchoInterval() {
+	if (!this->nodeInfo->echoTrickleEnabled || echoInterval <= this->nodeInfo->echoPeriod) {
+		return;
+	}
+	echoInterval = this->nodeInfo->echoPeriod;
+	Simulator::Cancel(sendEchoEvent);
+	sendEchoEvent = Simulator::Schedule(Seconds(rand->GetValue(0.000001, echoInterval.GetSeconds())),
+										&RntpStrategy::sendEchoInPeriodical, this);
+}
+
+void RntpStrategy::onMsgSent() {
+	lastSendTime = Simulator::Now();
 }
 
 void RntpStrategy::sendLltcNonPitData(Data& data) {
@@ -981,11 +1394,11 @@ void RntpStrategy::sendLltcNonPitData(Data& data) {
 	this->sendNonPitData(data, FaceEndpoint(*face_netdev, 0));
 }
 
-void RntpStrategy::addRoute(string producerPrefix, uint32_t consumerNodeID,
+void RntpStrategy::addRoute(uint32_t producerPrefixID, uint32_t consumerNodeID,
 							uint32_t n_hops, list<uint32_t>& nodeIDs, list<double>& channelQualities) {
 	if (enableLog_msgs) {
 		cout << "[Node " << nodeInfo->nodeID << ", " << Simulator::Now().GetNanoSeconds() << " ns] " <<
-				"add route with prefix: " << producerPrefix << ", consumerNodeID: " << consumerNodeID <<
+				"add route with prefix: " << prefixInterner.getPrefix(producerPrefixID) << ", consumerNodeID: " << consumerNodeID <<
 				", n_hops: " << n_hops << ", nodeIDs: ";
 
 		for (list<uint32_t>::iterator iter = nodeIDs.begin(); iter != nodeIDs.end(); ++iter) {
@@ -999,111 +1412,342 @@ void RntpStrategy::addRoute(string producerPrefix, uint32_t consumerNodeID,
 		cout << endl;
 	}
 
-	bool hasRoutesPerPair = false;
-	RoutesPerPair* routesPerPair = NULL;
-	for (vector<RoutesPerPair*>::iterator iter = this->routes_all.begin(); iter != this->routes_all.end(); ++iter) {
-		routesPerPair = *iter;
-		if (routesPerPair->producerPrefix == producerPrefix && routesPerPair->consumerNodeID == consumerNodeID) {
-			hasRoutesPerPair = true;
-			break;
-		}
+	// checked before the pair is touched, so that a route never stored leaves no pair nor shortest hop count behind
+	if (nodeIDs.size() > ROUTE_MAX_NODES) {
+		++nRoutesRejected_length;
+		return;
 	}
 
-	if (hasRoutesPerPair) {
-		for (auto route : routesPerPair->routes) {
-			if (route->nodeIDs.size() == nodeIDs.size()) {
-				bool theSame = true;
-				auto iter1 = route->nodeIDs.begin();
-				auto iter2 = nodeIDs.begin();
-				while (iter1 != route->nodeIDs.end()) {
-					if (*iter1 != *iter2) {
-						theSame = false;
-						break;
-					}
-					++iter1;
-					++iter2;
-				}
+	RoutesPerPair* routesPerPair = findRoutesPerPair(consumerNodeID, producerPrefixID);
 
-				if (theSame) {
-					cout << "duplicated route" << endl;
-					return;
-				}
+	if (routesPerPair != NULL) {
+		for (auto route : routesPerPair->routes) {
+			if (routesPerPair->store.isRouteEqual(route->slot, nodeIDs)) {
+				cout << "duplicated route" << endl;
+				route->updateTime = Simulator::Now();
+				return;
 			}
 		}
 
-		struct Route* route = new Route;
-		route->id = route_id_cur++;
-		route->n_hops = n_hops;
-		route->nodeIDs = nodeIDs;
-		route->channelQualities = channelQualities;
-		route->updateTime = Simulator::Now();
-		routesPerPair->routes.push_back(route);
-
 	} else {
 		routesPerPair = new RoutesPerPair;
-		routesPerPair->producerPrefix = producerPrefix;
+		routesPerPair->producerPrefixID = producerPrefixID;
 		routesPerPair->consumerNodeID = consumerNodeID;
-		routesPerPair->lastHitTime = Simulator::Now();
+		routesPerPair->n_hops_min = n_hops;
+		routesPerPair->lruPos = routesPerPair_lru.insert(routesPerPair_lru.end(), routesPerPair);
+		hitRoutesPerPair(routesPerPair);
+		routes_all[getFlowKey(producerPrefixID, consumerNodeID)] = routesPerPair;
+	}
+
+	if (n_hops < routesPerPair->n_hops_min) {
+		routesPerPair->n_hops_min = n_hops;
+	}
+	if (!isRouteWorthKeeping(routesPerPair, nodeIDs, channelQualities)) {
+		++nRoutesRejected_rank;
+		return;
+	}
 
-		struct Route* route = new Route;
-		route->id = route_id_cur++;
-		route->n_hops = n_hops;
-		route->nodeIDs = nodeIDs;
-		route->channelQualities = channelQualities;
-		route->updateTime = Simulator::Now();
-		routesPerPair->routes.push_back(route);
+	struct Route* route = new Route;
+	route->id = route_id_cur++;
+	route->n_hops = n_hops;
+	route->slot = routesPerPair->store.addRoute(nodeIDs);
+	route->updateTime = Simulator::Now();
+	route->metric = -1.0;
+	route->dirty = false;
+	route->routesPerPair = routesPerPair;
+	routesPerPair->routes.push_back(route);
+	routesPerPair->routes_ranked.insert(route);
+	indexRouteNeighbor(route, true);
+
+	if (nodeIDs.size() > 0) {
+		auto iter_nodeIDs = nodeIDs.begin();
+		uint32_t nodeID_prev = *iter_nodeIDs;
+		++iter_nodeIDs;
+		auto iter_qualities = channelQualities.begin();
+		uint32_t hop = 0;
+		for (; iter_nodeIDs != nodeIDs.end() && iter_qualities != channelQualities.end(); ++iter_nodeIDs, ++iter_qualities) {
+			Link* link = getOrCreateLink(nodeID_prev, *iter_nodeIDs, *iter_qualities);
+			link->routes[route] = hop;
+			route->links.push_back(link);
+			routesPerPair->store.setLinkQuality(route->slot, hop, getLinkWeight(link));
+			nodeID_prev = *iter_nodeIDs;
+			++hop;
+		}
+	}
+	route->dirty = true;
+	routesPerPair->routes_dirty.push_back(route);
 
-		routes_all.push_back(routesPerPair);
+	++nRoutes_total;
+	if (routesPerPair->routes.size() > this->nodeInfo->routeMaxPerPair) {
+		removeRoute(selectRouteToEvict(routesPerPair));
+		++nRoutesEvicted_cap;
+	}
+	enforceRouteTableBound();
+	if (nRoutes_total > nRoutes_highWater) {
+		nRoutes_highWater = nRoutes_total;
 	}
 }
 
-Route* RntpStrategy::matchRoute(uint32_t consumerNodeID, string producerPrefix, list<uint32_t> nodeIDs,
-								list<uint32_t>* nodeIDs_prev) {
-	unordered_set<uint32_t> prevNodes;
-	if (nodeIDs_prev != NULL) {
-		for (auto iter = nodeIDs_prev->rbegin(); iter != nodeIDs_prev->rend(); ++iter) {
-			if (*iter == this->nodeInfo->nodeID) {
-				break;
+// Bounds the discovery of a pair to the paths within discoveryHopSlack hops of the shortest one
+// seen so far, and whose bottleneck link is no worse than discoveryMinQuality
+bool RntpStrategy::isDiscoveredRouteAdmitted(uint32_t producerPrefixID, uint32_t consumerNodeID, uint32_t n_hops,
+											list<double>& channelQualities) {
+	if (getWorstChannelQuality(channelQualities) < this->nodeInfo->discoveryMinQuality) {
+		++nRoutesRejected_quality;
+		return false;
+	}
+	RoutesPerPair* routesPerPair = findRoutesPerPair(consumerNodeID, producerPrefixID);
+	if (routesPerPair != NULL && n_hops > routesPerPair->n_hops_min + this->nodeInfo->discoveryHopSlack) {
+		++nRoutesRejected_hops;
+		return false;
+	}
+	return true;
+}
+
+// Once a pair holds routeMaxPerPair routes, a new one that selectRouteToEvict would pick right
+// away, i.e., no better than the worst route and through a next hop already covered, is not
+// worth building
+bool RntpStrategy::isRouteWorthKeeping(RoutesPerPair* routesPerPair, list<uint32_t>& nodeIDs, list<double>& channelQualities) {
+	if (routesPerPair->routes.size() < this->nodeInfo->routeMaxPerPair || routesPerPair->routes.size() == 0) {
+		return true;
+	}
+	int nextHopID = getNextHop(nodeIDs);
+	bool isNextHopCovered = false;
+	for (Route* route : routesPerPair->routes) {
+		if (getNextHop(route) == nextHopID) {
+			isNextHopCovered = true;
+			break;
+		}
+	}
+	if (!isNextHopCovered) {
+		return true;
+	}
+
+	// scored by the route store itself, so a candidate equal to a stored route gets its very metric;
+	// it is then not kept, as it would rank below that route, which has the lower id
+	list<double> weights;
+	auto iter_nodeIDs = ++nodeIDs.begin();
+	for (auto iter = channelQualities.begin(); iter != channelQualities.end() && iter_nodeIDs != nodeIDs.end(); ++iter, ++iter_nodeIDs) {
+		double w = getLinkWeight(*iter_nodeIDs, *iter);
+		if (w <= QUALITY_BROKEN) {
+			return false;
+		}
+		weights.push_back(w);
+	}
+	double metric = RouteStore::computeMetric(weights, this->nodeInfo->routeMetricHopWeight);
+	refreshRouteMetrics(routesPerPair);
+	return metric > (*routesPerPair->routes_ranked.rbegin())->metric;
+}
+
+void RntpStrategy::removeRoute(Route* route) {
+	RoutesPerPair* routesPerPair = route->routesPerPair;
+	indexRouteNeighbor(route, false);
+	routesPerPair->routes_ranked.erase(route);
+	if (route->dirty) {
+		vector<Route*>& routes_dirty = routesPerPair->routes_dirty;
+		routes_dirty.erase(std::find(routes_dirty.begin(), routes_dirty.end(), route));
+	}
+
+	for (Link* link : route->links) {
+		if (link->routes.erase(route) > 0 && link->routes.size() == 0) {
+			links_all.erase(hashLink(link->fromNodeID, link->toNodeID));
+			auto iter_to = linksByToNodeID.find(link->toNodeID);
+			iter_to->second.erase(link);
+			if (iter_to->second.empty()) {
+				linksByToNodeID.erase(iter_to);
 			}
-			prevNodes.insert(*iter);
+			delete link;
 		}
 	}
 
-	for (route_table::iterator iter = routes_all.begin(); iter != routes_all.end(); ++iter) {
-		RoutesPerPair* routesPerPair = *iter;
-		if (routesPerPair->consumerNodeID == consumerNodeID && routesPerPair->producerPrefix == producerPrefix) {
-			for (vector<Route*>::iterator iter2 = routesPerPair->routes.begin(); iter2 != routesPerPair->routes.end(); ++iter2) {
-				Route* route = *iter2;
+	routesPerPair->store.removeRoute(route->slot);
+	Route* route_last = routesPerPair->routes.back();
+	routesPerPair->routes[route->slot] = route_last;
+	route_last->slot = route->slot;
+	routesPerPair->routes.pop_back();
 
-				auto iter_nodeIDs = nodeIDs.begin();
-				auto iter_route = route->nodeIDs.begin();
-				int k = 0;
-				for (; iter_nodeIDs != nodeIDs.end() && iter_route != route->nodeIDs.end(); ++iter_nodeIDs, ++iter_route) {
-					if (*iter_nodeIDs != *iter_route) break;
-					++k;
-				}
-				if (k == route->nodeIDs.size()) {
-					for (auto iter_quality = route->channelQualities.begin();
-							iter_quality != route->channelQualities.end(); ++iter_quality) {
-						if (*iter_quality == QUALITY_BROKEN) {
-							return NULL;
-						}
-					}
+	delete route;
+	--nRoutes_total;
+}
 
-					return route;
+// counts the routes of each flow through each neighbor, i.e., the node before this one in the route
+void RntpStrategy::indexRouteNeighbor(Route* route, bool isAdded) {
+	RouteStore& store = route->routesPerPair->store;
+	uint32_t n = store.getNNodes(route->slot);
+	if (n <= 1) {
+		return;
+	}
+	uint32_t neighborID = store.getNodeIDs(route->slot)[n - 2];
+	uint64_t flowKey = getFlowKey(route->routesPerPair->producerPrefixID, route->routesPerPair->consumerNodeID);
+	if (isAdded) {
+		++flowsPerNeighbor[neighborID][flowKey];
+		return;
+	}
+	auto iter = flowsPerNeighbor.find(neighborID);
+	if (iter == flowsPerNeighbor.end()) {
+		return;
+	}
+	auto iter2 = iter->second.find(flowKey);
+	if (iter2 != iter->second.end() && --iter2->second == 0) {
+		iter->second.erase(iter2);
+		if (iter->second.empty()) {
+			flowsPerNeighbor.erase(iter);
+		}
+	}
+}
+
+void RntpStrategy::removeRoutesPerPair(RoutesPerPair* routesPerPair) {
+	while (routesPerPair->routes.size() > 0) {
+		removeRoute(routesPerPair->routes.back());
+	}
+	routes_all.erase(getFlowKey(routesPerPair->producerPrefixID, routesPerPair->consumerNodeID));
+	routesPerPair_lru.erase(routesPerPair->lruPos);
+	delete routesPerPair;
+}
+
+void RntpStrategy::hitRoutesPerPair(RoutesPerPair* routesPerPair) {
+	routesPerPair->lastHitTime = Simulator::Now();
+	routesPerPair_lru.splice(routesPerPair_lru.end(), routesPerPair_lru, routesPerPair->lruPos);
+}
+
+// the worst route whose next hop is shared with a better route, so that the routes kept
+// stay diverse in their next hops; or the worst route if all next hops are distinct
+Route* RntpStrategy::selectRouteToEvict(RoutesPerPair* routesPerPair) {
+	refreshRouteMetrics(routesPerPair);
+	unordered_map<uint32_t, uint32_t> nRoutesPerNextHop;
+	for (Route* route : routesPerPair->routes) {
+		++nRoutesPerNextHop[getNextHop(route)];
+	}
+	for (auto iter = routesPerPair->routes_ranked.rbegin(); iter != routesPerPair->routes_ranked.rend(); ++iter) {
+		if (nRoutesPerNextHop[getNextHop(*iter)] > 1) {
+			return *iter;
+		}
+	}
+	return *routesPerPair->routes_ranked.rbegin();
+}
+
+// evicts from the least recently hit pairs until the node-wide bound is met
+void RntpStrategy::enforceRouteTableBound() {
+	while (nRoutes_total > this->nodeInfo->routeTableMaxRoutes && routesPerPair_lru.size() > 0) {
+		RoutesPerPair* routesPerPair = routesPerPair_lru.front();
+		removeRoute(selectRouteToEvict(routesPerPair));
+		++nRoutesEvicted_bound;
+		if (routesPerPair->routes.size() == 0) {
+			removeRoutesPerPair(routesPerPair);
+		}
+	}
+}
+
+void RntpStrategy::ageRoutes() {
+	ns3::Time now = Simulator::Now();
+	ns3::Time idleTimeout = this->nodeInfo->routeIdleTimeout;
+	ns3::Time staleTimeout = this->nodeInfo->routeStaleTimeout;
+
+	while (idleTimeout.IsStrictlyPositive() && routesPerPair_lru.size() > 0 &&
+			now - routesPerPair_lru.front()->lastHitTime > idleTimeout) {
+		nRoutesEvicted_idle += routesPerPair_lru.front()->routes.size();
+		removeRoutesPerPair(routesPerPair_lru.front());
+	}
+
+	vector<RoutesPerPair*> routes_all_cur;
+	for (auto& entry : routes_all) {
+		routes_all_cur.push_back(entry.second);
+	}
+	for (RoutesPerPair* routesPerPair : routes_all_cur) {
+		if (staleTimeout.IsStrictlyPositive()) {
+			vector<Route*> routes_cur = routesPerPair->routes;
+			for (Route* route : routes_cur) {
+				// a backup route unused since its discovery stays fresh while its link towards this
+				// node is heard, as discovery is not repeated for it
+				ns3::Time updateTime = route->updateTime;
+				for (Link* link : route->links) {
+					if (link->toNodeID == this->nodeInfo->nodeID && link->updateTime > updateTime) {
+						updateTime = link->updateTime;
+					}
 				}
+				if (now - updateTime > staleTimeout) {
+					removeRoute(route);
+					++nRoutesEvicted_stale;
+				}
+			}
+			if (routesPerPair->routes.size() == 0) {
+				removeRoutesPerPair(routesPerPair);
+			}
+		}
+	}
 
+	ageRoutesEvent = Simulator::Schedule(this->nodeInfo->routeAgingPeriod, &RntpStrategy::ageRoutes, this);
+}
+
+uint64_t RntpStrategy::hashLink(uint32_t fromNodeID, uint32_t toNodeID) {
+	return (uint64_t) fromNodeID << 32 | (uint64_t) toNodeID;
+}
+
+Link* RntpStrategy::getOrCreateLink(uint32_t fromNodeID, uint32_t toNodeID, double quality) {
+	uint64_t h = hashLink(fromNodeID, toNodeID);
+	auto iter = links_all.find(h);
+	if (iter != links_all.end()) {
+		// links towards this node are maintained by updateChannelQuality, whereas
+		// remote links take the freshest quality advertised in InterestBroadcasts
+		if (toNodeID != this->nodeInfo->nodeID) {
+			setLinkQuality(iter->second, quality);
+		}
+		return iter->second;
+	}
+
+	Link* link = new Link;
+	link->fromNodeID = fromNodeID;
+	link->toNodeID = toNodeID;
+	link->quality = quality;
+	link->updateTime = Simulator::Now();
+	if (toNodeID == this->nodeInfo->nodeID) {
+		auto iter_cqs = channelQualities.find(fromNodeID);
+		if (iter_cqs != channelQualities.end()) {
+			link->quality = iter_cqs->second.quality_smooth;
+		}
+	}
+	links_all[h] = link;
+	linksByToNodeID[toNodeID].insert(link);
+	return link;
+}
+
+Route* RntpStrategy::matchRoute(uint32_t consumerNodeID, uint32_t producerPrefixID, list<uint32_t> nodeIDs,
+								list<uint32_t>* nodeIDs_prev) {
+	RoutesPerPair* routesPerPair = findRoutesPerPair(consumerNodeID, producerPrefixID);
+	if (routesPerPair == NULL) {
+		return NULL;
+	}
+
+	for (vector<Route*>::iterator iter2 = routesPerPair->routes.begin(); iter2 != routesPerPair->routes.end(); ++iter2) {
+		Route* route = *iter2;
+
+		const uint32_t* nodeIDs_route = routesPerPair->store.getNodeIDs(route->slot);
+		uint32_t n = routesPerPair->store.getNNodes(route->slot);
+		auto iter_nodeIDs = nodeIDs.begin();
+		uint32_t k = 0;
+		for (; iter_nodeIDs != nodeIDs.end() && k < n; ++iter_nodeIDs) {
+			if (*iter_nodeIDs != nodeIDs_route[k]) break;
+			++k;
+		}
+		if (k == n) {
+			refreshRouteMetrics(routesPerPair);
+			if (route->metric < 0) {
+				return NULL;
 			}
+			hitRoutesPerPair(routesPerPair);
+			route->updateTime = routesPerPair->lastHitTime;
+			return route;
 		}
 	}
 	return NULL;
 }
 
-
-Route* RntpStrategy::lookupRoute(uint32_t consumerNodeID, string producerPrefix,
+Route* RntpStrategy::lookupRoute(uint32_t consumerNodeID, uint32_t producerPrefixID,
 								list<uint32_t>* nodeIDs_prev, uint32_t rank) {
-	refreshRouteMetric(consumerNodeID, producerPrefix);
-	dumpRoute(consumerNodeID, producerPrefix);
+	RoutesPerPair* routesPerPair = findRoutesPerPair(consumerNodeID, producerPrefixID);
+	if (routesPerPair == NULL) {
+		return NULL;
+	}
 
 	unordered_set<uint32_t> prevNodes;
 	if (nodeIDs_prev != NULL) {
@@ -1115,131 +1759,227 @@ Route* RntpStrategy::lookupRoute(uint32_t consumerNodeID, string producerPrefix,
 		}
 	}
 
-	for (route_table::iterator iter = routes_all.begin(); iter != routes_all.end(); ++iter) {
-		RoutesPerPair* routesPerPair = *iter;
-		if (routesPerPair->consumerNodeID == consumerNodeID && routesPerPair->producerPrefix == producerPrefix) {
-			vector<Route*> routes_ranked;
-			unordered_map<uint32_t, double> routeIDToMetricMap;
-			for (vector<Route*>::iterator iter2 = routesPerPair->routes.begin(); iter2 != routesPerPair->routes.end(); ++iter2) {
-				Route* route = *iter2;
-
-				bool isLoop = false;
-				for (auto iter = route->nodeIDs.begin(); iter != route->nodeIDs.end(); ++iter) {
-					if (prevNodes.find(*iter) != prevNodes.end()) {
-						isLoop = true;
-						break;
-					}
-				}
-				if (isLoop) {
-					continue;
-				}
-
-				routeIDToMetricMap[route->id] = route->metric;
-				auto iter_ranked = routes_ranked.begin();
-				for (; iter_ranked != routes_ranked.end(); ++iter_ranked) {
-					if ((*iter_ranked)->metric < route->metric) {
-						break;
-					}
-				}
-				if (iter_ranked != routes_ranked.end()) {
-					routes_ranked.insert(iter_ranked, route);
-				} else {
-					routes_ranked.push_back(route);
+	refreshRouteMetrics(routesPerPair);
+
+	// walk the routes from the best one, skipping those looping through the previous nodes,
+	// so that the rank-th alternative is found without ranking the whole table
+	Route* route_found = NULL;
+	vector<Route*> routes_eligible;
+	for (Route* route : routesPerPair->routes_ranked) {
+		bool isLoop = false;
+		if (prevNodes.size() > 0) {
+			const uint32_t* nodeIDs_route = routesPerPair->store.getNodeIDs(route->slot);
+			uint32_t n = routesPerPair->store.getNNodes(route->slot);
+			for (uint32_t i = 0; i < n; ++i) {
+				if (prevNodes.find(nodeIDs_route[i]) != prevNodes.end()) {
+					isLoop = true;
+					break;
 				}
 			}
-
-			uint32_t n = routes_ranked.size();
-			return n == 0 ? NULL : (n > rank ? routes_ranked[rank] : routes_ranked[rank % n]);
 		}
+		if (isLoop) {
+			continue;
+		}
+		if (routes_eligible.size() == rank) {
+			route_found = route;
+			break;
+		}
+		routes_eligible.push_back(route);
 	}
-	return NULL;
+
+	uint32_t n = routes_eligible.size();
+	if (route_found == NULL && n > 0) {
+		route_found = routes_eligible[rank % n];
+	}
+	if (route_found != NULL) {
+		hitRoutesPerPair(routesPerPair);
+		route_found->updateTime = routesPerPair->lastHitTime;
+	}
+	return route_found;
 }
 
-void RntpStrategy::refreshRouteMetric(uint32_t consumerNodeID, string producerPrefix) {
-	for (route_table::iterator iter = routes_all.begin(); iter != routes_all.end(); ++iter) {
-		RoutesPerPair* routesPerPair = *iter;
-		if (routesPerPair->consumerNodeID == consumerNodeID && routesPerPair->producerPrefix == producerPrefix) {
-			double quality_higest = -10000000000000.0;
-			double quality_lowest = DBL_MAX;
-			for (vector<Route*>::iterator iter2 = routesPerPair->routes.begin();
-					iter2 != routesPerPair->routes.end(); ++iter2) {
-				Route* route = *iter2;
+// the route the capsule already follows, a striped one at the producer, or else the best one
+// (the next best ones when retrying)
+Route* RntpStrategy::chooseRoute(TransportStates* ts, CapsuleInfo& capInfo, int code, uint32_t nTimesRetried,
+								bool canStripe, bool* isStriped) {
+	*isStriped = false;
+	Route* route = this->matchRoute(capInfo.consumerNodeID, capInfo.prefixID, capInfo.nodeIDs, &capInfo.nodeIDs);
+
+	// only the producer stripes, and only the first attempt; relays follow the route in the capsule
+	if (route == NULL && this->nodeInfo->stripingEnabled && code != SEND_CAP_FOR_RETRYING &&
+			capInfo.nodeIDs.size() == 0 && canStripe) {
+		route = this->selectStripedRoute(ts, capInfo.consumerNodeID, capInfo.prefixID);
+		*isStriped = route != NULL;
+	}
 
-				for (list<double>::iterator iter3 = route->channelQualities.begin();
-						iter3 != route->channelQualities.end(); ++iter3) {
-					double quality = *iter3;
-					if (quality <= QUALITY_BROKEN) {
-						(*iter2)->metric = -1.0;
-						continue;
-					}
-					if (quality > quality_higest) {
-						quality_higest = quality;
-					}
+	if (route == NULL) {
+		uint32_t rank = 0;
+		if (code == SEND_CAP_FOR_RETRYING) {
+			rank = nTimesRetried + 1;
+		}
+		route = this->lookupRoute(capInfo.consumerNodeID, capInfo.prefixID, &capInfo.nodeIDs, rank);
+	}
+	return route;
+}
 
-					if (quality < quality_lowest) {
-						quality_lowest = quality;
-					}
-				}
-			}
+// Spreads the capsules of a flow over the top diverse routes: each capsule goes to the route
+// furthest below its share of the capsules in flight, with shares following the metric and the
+// delivery rate of the routes. A route other than the best only takes capsules while it holds
+// fewer than its share of the reorder budget, shrunk by the hops it has over the best route,
+// as its capsules arrive behind those sent later on the best route.
+Route* RntpStrategy::selectStripedRoute(TransportStates* ts, uint32_t consumerNodeID, uint32_t producerPrefixID) {
+	RoutesPerPair* routesPerPair = findRoutesPerPair(consumerNodeID, producerPrefixID);
+	if (routesPerPair == NULL) {
+		return NULL;
+	}
+	refreshRouteMetrics(routesPerPair);
 
-			if (quality_higest <= QUALITY_BROKEN) return;
+	// node-disjoint in their relays, i.e., all nodes but the consumer first and this node last
+	vector<Route*> paths;
+	unordered_set<uint32_t> relays_used;
+	for (Route* route : routesPerPair->routes_ranked) {
+		if (paths.size() == this->nodeInfo->stripingMaxPaths || route->metric <= 0) {
+			break;
+		}
+		const uint32_t* nodeIDs = routesPerPair->store.getNodeIDs(route->slot);
+		uint32_t n = routesPerPair->store.getNNodes(route->slot);
+		bool isDisjoint = true;
+		for (uint32_t i = 1; i + 1 < n; ++i) {
+			if (relays_used.find(nodeIDs[i]) != relays_used.end()) {
+				isDisjoint = false;
+				break;
+			}
+		}
+		if (!isDisjoint) {
+			continue;
+		}
+		for (uint32_t i = 1; i + 1 < n; ++i) {
+			relays_used.insert(nodeIDs[i]);
+		}
+		paths.push_back(route);
+	}
+	if (paths.size() == 0) {
+		return NULL;
+	}
 
-			Route* route_best = NULL;
+	vector<double> weights;
+	double weightSum = 0.0;
+	for (Route* route : paths) {
+		StripePath& path = ts->stripePaths.emplace(route->id, StripePath{0, 1.0}).first->second;
+		double weight = route->metric * std::max(path.deliveryRate, STRIPE_MIN_DELIVERY_RATE);
+		weights.push_back(weight);
+		weightSum += weight;
+	}
 
-			for (vector<Route*>::iterator iter2 = routesPerPair->routes.begin(); iter2 != routesPerPair->routes.end(); ++iter2) {
-				Route* route = *iter2;
-				double metric = 1.0;
-				int k = 0;
-				for (list<double>::iterator iter3 = route->channelQualities.begin();
-						iter3 != route->channelQualities.end(); ++iter3) {
-					double quality = *iter3;
-					if (quality <= QUALITY_BROKEN) {
-						metric = -1.0;
-						break;
-					}
-					metric *= quality;
-					++k;
-				}
-				if (metric >= 0)
-					(*iter2)->metric = pow(metric, 1.0 / (2 * k));
-				else
-					(*iter2)->metric = -1.0;
+	Route* route_chosen = NULL;
+	double score_best = -1.0;
+	uint32_t nNodes_best = routesPerPair->store.getNNodes(paths[0]->slot);
+	for (uint32_t i = 0; i < paths.size(); ++i) {
+		StripePath& path = ts->stripePaths[paths[i]->id];
+		if (i > 0) {
+			uint32_t nNodes = routesPerPair->store.getNNodes(paths[i]->slot);
+			uint32_t nHops_extra = nNodes > nNodes_best ? nNodes - nNodes_best : 0;
+			double budget = this->nodeInfo->stripingMaxReorder * weights[i] / weightSum / (1 + nHops_extra);
+			if (path.nInFlight >= budget) {
+				continue;
 			}
+		}
+		double score = weights[i] / (path.nInFlight + 1);
+		if (score > score_best) {
+			score_best = score;
+			route_chosen = paths[i];
+		}
+	}
 
-			return;
+	// routes no longer striped over are forgotten once their capsules are settled
+	for (auto iter = ts->stripePaths.begin(); iter != ts->stripePaths.end();) {
+		bool isUsed = false;
+		for (Route* route : paths) {
+			if (route->id == iter->first) {
+				isUsed = true;
+				break;
+			}
+		}
+		if (!isUsed && iter->second.nInFlight == 0) {
+			iter = ts->stripePaths.erase(iter);
+		} else {
+			++iter;
 		}
 	}
+
+	hitRoutesPerPair(routesPerPair);
+	route_chosen->updateTime = routesPerPair->lastHitTime;
+	return route_chosen;
+}
+
+void RntpStrategy::updateStripePath(TransportStates* ts, SendCapState* tranState, bool isDelivered) {
+	if (!tranState->isStriped) {
+		return;
+	}
+	auto iter = ts->stripePaths.find(tranState->stripeRouteID);
+	if (iter == ts->stripePaths.end()) {
+		return;
+	}
+	double alpha = this->nodeInfo->stripingDeliveryAlpha;
+	iter->second.deliveryRate = (1 - alpha) * iter->second.deliveryRate + (isDelivered ? alpha : 0.0);
+}
+
+RoutesPerPair* RntpStrategy::findRoutesPerPair(uint32_t consumerNodeID, uint32_t producerPrefixID) {
+	auto iter = routes_all.find(getFlowKey(producerPrefixID, consumerNodeID));
+	return iter == routes_all.end() ? NULL : iter->second;
+}
+
+void RntpStrategy::refreshRouteMetrics(RoutesPerPair* routesPerPair) {
+	if (routesPerPair->routes_dirty.size() == 0) {
+		return;
+	}
+	// the ranked set is keyed by metric, so the dirty routes leave it before their metrics change
+	for (Route* route : routesPerPair->routes_dirty) {
+		routesPerPair->routes_ranked.erase(route);
+	}
+	routesPerPair->store.computeMetrics(this->nodeInfo->routeMetricHopWeight);
+	for (Route* route : routesPerPair->routes_dirty) {
+		route->metric = routesPerPair->store.getMetric(route->slot);
+		route->dirty = false;
+		routesPerPair->routes_ranked.insert(route);
+	}
+	routesPerPair->routes_dirty.clear();
 }
 
 int RntpStrategy::updateRoutesWithQuality(uint32_t fromNodeID, uint32_t toNodeID, double channelQuality) {
-	int nRadicalChanges = 0;
-	for (route_table::iterator iter = routes_all.begin(); iter != routes_all.end(); ++iter) {
-		RoutesPerPair* routesPerPair = *iter;
-		for (vector<Route*>::iterator iter2 = routesPerPair->routes.begin(); iter2 != routesPerPair->routes.end(); ++iter2) {
-			Route* route = *iter2;
-			if (route->nodeIDs.size() <= 1) continue;
-
-			list<uint32_t>::iterator iter_nodeIDs = route->nodeIDs.begin();
-			uint32_t nodeID_prev = *iter_nodeIDs;
-			++iter_nodeIDs;
-			list<double>::iterator iter_qualities = route->channelQualities.begin();
-			bool radicalChange = false;
-			for (; iter_nodeIDs != route->nodeIDs.end(); ++iter_nodeIDs) {
-				uint32_t nodeID_cur = *iter_nodeIDs;
-				if (nodeID_prev == fromNodeID && nodeID_cur == toNodeID) {
-					if ((*iter_qualities == QUALITY_BROKEN && channelQuality > QUALITY_BROKEN) ||
-						(*iter_qualities > QUALITY_BROKEN && channelQuality == QUALITY_BROKEN)) {
-						radicalChange = true;
-					}
-					*iter_qualities = channelQuality;
-				}
-				nodeID_prev = nodeID_cur;
-				++iter_qualities;
-			}
-			if (radicalChange) ++nRadicalChanges;
+	auto iter = links_all.find(hashLink(fromNodeID, toNodeID));
+	if (iter == links_all.end()) {
+		return 0;
+	}
+	if (channelQuality > QUALITY_BROKEN) {
+		iter->second->updateTime = Simulator::Now();
+	}
+	return setLinkQuality(iter->second, channelQuality);
+}
+
+int RntpStrategy::setLinkQuality(Link* link, double channelQuality) {
+	double quality_prev = link->quality;
+	if (quality_prev == channelQuality) {
+		return 0;
+	}
+	bool radicalChange = (quality_prev == QUALITY_BROKEN && channelQuality > QUALITY_BROKEN) ||
+						 (quality_prev > QUALITY_BROKEN && channelQuality == QUALITY_BROKEN);
+	link->quality = channelQuality;
+	applyLinkWeight(link);
+	return radicalChange ? link->routes.size() : 0;
+}
+
+void RntpStrategy::applyLinkWeight(Link* link) {
+	double weight = getLinkWeight(link);
+	for (auto& routeAndHop : link->routes) {
+		Route* route = routeAndHop.first;
+		RoutesPerPair* routesPerPair = route->routesPerPair;
+		routesPerPair->store.setLinkQuality(route->slot, routeAndHop.second, weight);
+		if (!route->dirty) {
+			route->dirty = true;
+			routesPerPair->routes_dirty.push_back(route);
 		}
 	}
-	return nRadicalChanges;
 }
 
 
@@ -1249,6 +1989,7 @@ void RntpStrategy::markChannelBroken(uint32_t fromNodeID, string reason) {
 	ns3::Time now = Simulator::Now();
 	ChannelQualityStates& cqs = iter->second;
 	this->updateRoutesWithQuality(fromNodeID, this->nodeInfo->nodeID, QUALITY_BROKEN);
+	resetEchoInterval();
 
 	if (enableLog_msgs) {
 		cout << "[Node " << nodeInfo->nodeID << ", " << Simulator::Now().GetNanoSeconds() << " ns] << update a link between "
@@ -1256,22 +1997,86 @@ void RntpStrategy::markChannelBroken(uint32_t fromNodeID, string reason) {
 	}
 }
 
+// A capsule sent to the neighbor is acknowledged or times out. The link quality follows for the
+// estimators counting deliveries, unless the link has been marked broken, which only a message
+// heard from the neighbor undoes.
+void RntpStrategy::updateLinkDelivery(uint32_t neighborID, bool isDelivered) {
+	auto iter = channelQualities.find(neighborID);
+	if (iter == channelQualities.end()) {
+		return;
+	}
+	ChannelQualityStates& cqs = iter->second;
+	linkEstimator->onCapAckResult(cqs.estimate, isDelivered);
+	double quality = linkEstimator->getQuality(cqs.estimate);
+	if (quality == cqs.quality_smooth) {
+		return;
+	}
+	cqs.quality_smooth = quality;
+	auto iter_link = links_all.find(hashLink(neighborID, this->nodeInfo->nodeID));
+	if (iter_link != links_all.end() && iter_link->second->quality != QUALITY_BROKEN) {
+		this->updateRoutesWithQuality(neighborID, this->nodeInfo->nodeID, quality);
+	}
+}
+
+void RntpStrategy::onWaitMsgTimer(uint32_t fromNodeID) {
+	auto iter = channelQualities.find(fromNodeID);
+	if (iter == channelQualities.end()) {
+		return;
+	}
+	ChannelQualityStates& cqs = iter->second;
+	ns3::Time now = Simulator::Now();
+	// the silence of a neighbor while this node sleeps is not the neighbor's
+	if (isRadioAsleep) {
+		cqs.waitMsgDeadline = max(cqs.waitMsgDeadline, getNextDutyCycleSlot() + this->nodeInfo->dutyCycleAwakeTime);
+	}
+	// the threshold of a neighbor carrying data only holds while this node awaits its ACKs, as its
+	// silence may otherwise be the end of its flow, after which it is heard through its Echoes
+	if (!isAwaitingMsgsFrom(fromNodeID)) {
+		ns3::Time minSilence = min(this->nodeInfo->livenessMinSilence, this->nodeInfo->msgTimeout);
+		cqs.waitMsgDeadline = max(cqs.waitMsgDeadline, cqs.liveness->getLastArrival() + minSilence);
+	}
+	if (cqs.waitMsgDeadline > now) {
+		cqs.waitMsgTimerExpiry = cqs.waitMsgDeadline;
+		cqs.waitMsgTimerID = timerWheel.schedule(cqs.waitMsgDeadline - now, [this, fromNodeID]() {
+			this->onWaitMsgTimer(fromNodeID);
+		});
+		return;
+	}
+	++nLinksBrokenBySilence;
+	secsSilentBeforeBroken_total += (now - cqs.liveness->getLastArrival()).GetSeconds();
+	markChannelBroken(fromNodeID, "message timeout");
+}
+
+// capsules queued for a flow whose next hop is the neighbor are waiting for its ACKs
+bool RntpStrategy::isAwaitingMsgsFrom(uint32_t neighborID) {
+	auto iter_flows = flowsPerNeighbor.find(neighborID);
+	if (iter_flows == flowsPerNeighbor.end()) {
+		return false;
+	}
+	for (auto iter = iter_flows->second.begin(); iter != iter_flows->second.end(); ++iter) {
+		auto iter_ts = transportStates_all.find(iter->first);
+		if (iter_ts != transportStates_all.end() && iter_ts->second->capSendQueue.countElements() > 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
 double RntpStrategy::findEquivalentQualityOfBestRoute(uint32_t upstreamNeighboredNodeID) {
 	vector<double> equiQualities;
 	for (route_table::iterator iter = routes_all.begin(); iter != routes_all.end(); ++iter) {
-		RoutesPerPair* routesPerPair = *iter;
-		refreshRouteMetric(routesPerPair->consumerNodeID, routesPerPair->producerPrefix);
+		RoutesPerPair* routesPerPair = iter->second;
 		Route* route_best = NULL;
 		Route* route_related = NULL;
 		double metric_highest = -1.0;
 		bool viable = false;
+		RouteStore& store = routesPerPair->store;
+		refreshRouteMetrics(routesPerPair);
 		for (vector<Route*>::iterator iter2 = routesPerPair->routes.begin();
 				iter2 != routesPerPair->routes.end(); ++iter2) {
 			Route* route = *iter2;
-			auto iter3 = route->nodeIDs.end();
-			--iter3;
-			--iter3;
-			if (*iter3 == upstreamNeighboredNodeID) {
+			uint32_t n = store.getNNodes(route->slot);
+			if (n >= 2 && store.getNodeIDs(route->slot)[n - 2] == upstreamNeighboredNodeID) {
 				route_related = route;
 			}
 
@@ -1284,49 +2089,32 @@ double RntpStrategy::findEquivalentQualityOfBestRoute(uint32_t upstreamNeighbore
 			equiQualities.push_back(QUALITY_BROKEN);
 			continue;
 		}
-		auto iter_best = route_best->nodeIDs.begin();
+		const uint32_t* nodeIDs_best = store.getNodeIDs(route_best->slot);
+		uint32_t n_best = store.getNNodes(route_best->slot);
 		int k = -1;
 		if (route_related == NULL) {
-			k = route_best->nodeIDs.size();
+			k = n_best;
 		} else {
-			auto iter_related = route_related->nodeIDs.begin();
-
-			for (; iter_best != route_best->nodeIDs.end() && iter_related != route_related->nodeIDs.end();
-					++iter_best, ++iter_related) {
-				if (*iter_best != *iter_related) {
+			const uint32_t* nodeIDs_related = store.getNodeIDs(route_related->slot);
+			uint32_t n_related = store.getNNodes(route_related->slot);
+			for (uint32_t i = 0; i < n_best && i < n_related; ++i) {
+				if (nodeIDs_best[i] != nodeIDs_related[i]) {
 					break;
 				}
 				++k;
 			}
 		}
 
-		int i = 0;
 		double best_quality_product = 1.0;
-		for (auto iter_quality_best = route_best->channelQualities.begin();
-				iter_quality_best != route_best->channelQualities.end();
-				++iter_quality_best) {
-			if (i < k) {
-				++i;
-				continue;
-			}
-			best_quality_product *= *iter_quality_best;
-			++i;
+		for (int i = k; i < (int) route_best->links.size(); ++i) {
+			best_quality_product *= route_best->links[i]->quality;
 		}
 
 		double related_quality_product = 1.0;
 		if (route_related != NULL) {
-			int n = route_related->channelQualities.size();
-			i = 0;
-			for (auto iter_quality_related = route_related->channelQualities.begin();
-					iter_quality_related != route_related->channelQualities.end();
-					++iter_quality_related) {
-				if (i < k) {
-					++i;
-					continue;
-				}
-				if (i == n - 1) break;
-				related_quality_product *= *iter_quality_related;
-				++i;
+			int n = route_related->links.size();
+			for (int i = k; i < n - 1; ++i) {
+				related_quality_product *= route_related->links[i]->quality;
 			}
 		}
 
@@ -1345,36 +2133,29 @@ double RntpStrategy::findEquivalentQualityOfBestRoute(uint32_t upstreamNeighbore
 set<uint32_t> RntpStrategy::getNeighboredIDsInRoutes() {
 	set<uint32_t> neighbors;
 	for (route_table::iterator iter = routes_all.begin(); iter != routes_all.end(); ++iter) {
-		RoutesPerPair* routesPerPair = *iter;
+		RoutesPerPair* routesPerPair = iter->second;
 		for (vector<Route*>::iterator iter2 = routesPerPair->routes.begin(); iter2 != routesPerPair->routes.end(); ++iter2) {
 			Route* route = *iter2;
-			if (route->nodeIDs.size() <= 1) continue;
+			uint32_t n = routesPerPair->store.getNNodes(route->slot);
+			if (n <= 1) continue;
 
-			list<uint32_t>::iterator iter_nodeIDs = route->nodeIDs.end();
-			--iter_nodeIDs;
-			--iter_nodeIDs;
-			uint32_t neighborID = *iter_nodeIDs;
+			uint32_t neighborID = routesPerPair->store.getNodeIDs(route->slot)[n - 2];
 			neighbors.insert(neighborID);
 		}
 	}
 	return neighbors;
 }
 
-set<uint32_t> RntpStrategy::getNeighboredIDsInRoutes(uint32_t consumerID, string prefix) {
+set<uint32_t> RntpStrategy::getNeighboredIDsInRoutes(uint32_t consumerID, uint32_t prefixID) {
 	set<uint32_t> neighbors;
-	for (route_table::iterator iter = routes_all.begin(); iter != routes_all.end(); ++iter) {
-		RoutesPerPair* routesPerPair = *iter;
-		if (routesPerPair->consumerNodeID != consumerID && routesPerPair->producerPrefix != prefix) {
-			continue;
-		}
+	RoutesPerPair* routesPerPair = findRoutesPerPair(consumerID, prefixID);
+	if (routesPerPair != NULL) {
 		for (vector<Route*>::iterator iter2 = routesPerPair->routes.begin(); iter2 != routesPerPair->routes.end(); ++iter2) {
 			Route* route = *iter2;
-			if (route->nodeIDs.size() <= 1) continue;
+			uint32_t n = routesPerPair->store.getNNodes(route->slot);
+			if (n <= 1) continue;
 
-			list<uint32_t>::iterator iter_nodeIDs = route->nodeIDs.end();
-			--iter_nodeIDs;
-			--iter_nodeIDs;
-			uint32_t neighborID = *iter_nodeIDs;
+			uint32_t neighborID = routesPerPair->store.getNodeIDs(route->slot)[n - 2];
 			neighbors.insert(neighborID);
 		}
 	}
@@ -1410,13 +2191,15 @@ double RntpStrategy::estimateBER(double snr) {
 	  return ber;
 }
 
-int32_t RntpStrategy::findPrefix(string prefix) {
-	int32_t i;
-	for (vector<string>::iterator iter = nodeInfo->prefixes.begin(); iter != nodeInfo->prefixes.end(); ++iter) {
-		if (*iter == prefix) {
+int32_t RntpStrategy::findPrefix(uint32_t prefixID) {
+	// the prefixes are registered after the strategy is installed, so they are interned lazily
+	while (localPrefixIDs.size() < nodeInfo->prefixes.size()) {
+		localPrefixIDs.push_back(prefixInterner.intern(nodeInfo->prefixes[localPrefixIDs.size()]));
+	}
+	for (int32_t i = 0; i < (int32_t) localPrefixIDs.size(); ++i) {
+		if (localPrefixIDs[i] == prefixID) {
 			return i;
 		}
-		++i;
 	}
 	return -1;
 }
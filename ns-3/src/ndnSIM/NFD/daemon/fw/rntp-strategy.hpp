@@ -21,8 +21,11 @@
 #include "ndn-cxx/tag.hpp"
 #include "NFD/daemon/face/face-endpoint.hpp"
 #include <list>
+#include <set>
 #include <unordered_map>
 #include <queue>
+#include <new>
+#include <functional>
 
 #include "generic-routes-manager.hpp"
 #include "ns3/nist-error-rate-model.h"
@@ -38,6 +41,15 @@ class RntpStrategy;
 typedef void (*route_searched_callback) (RntpStrategy*, unsigned int);  // parameter: rreqId
 
 #define QUALITY_BROKEN			-1000000000.0
+#define QUALITY_MIN_POSITIVE	1e-12
+
+// the most nodes a route is stored with, consumer and this node included; a longer route found
+// in a discovery is rejected and counted in nRoutesRejected_length
+#define ROUTE_MAX_NODES			32
+#define ROUTE_MAX_LINKS			(ROUTE_MAX_NODES - 1)
+
+// relative change in an advertised node weight below which the routes through the node are kept as they are
+#define NODE_WEIGHT_MIN_CHANGE	0.01
 
 struct PhyInfo {
 	double snr;
@@ -51,12 +63,13 @@ struct RouteTagInfo {
 
 struct InterestInfo {
 	string 			prefix;
+	uint32_t		prefixID;
 	uint32_t 		consumerNodeID;
 	uint32_t 		nextHopNodeID;
 };
 
 struct CapsuleInfo {
-	string 			prefix;
+	uint32_t 		prefixID;
 	uint32_t 		dataID;
 	uint32_t 		consumerNodeID;
 	uint32_t 		transHopNodeID;
@@ -66,7 +79,7 @@ struct CapsuleInfo {
 };
 
 struct CapsuleACKInfo {
-	string 			prefix;
+	uint32_t 		prefixID;
 	list<uint32_t> 	dataIDsReceived;
 	uint32_t 		downstreamNodeID;
 	list<uint32_t>	upstreamNodeIDs;
@@ -74,39 +87,127 @@ struct CapsuleACKInfo {
 	uint32_t		consumerNodeID;
 };
 
+// Asks the nodes towards the producer, nearest first, for capsules the consumer has missed.
+struct CapsuleRepairInfo {
+	uint32_t 		prefixID;
+	list<uint32_t> 	dataIDsMissing;
+	uint32_t 		requesterNodeID;
+	list<uint32_t>	upstreamNodeIDs;   // the first is asked next, the last is the producer
+	uint32_t		consumerNodeID;
+};
+
 struct InterestBroadcastInfo {
 	uint32_t 		hopCount;
-	string 			producerPrefix;
+	uint32_t 		producerPrefixID;
 	uint32_t 		consumerNodeID;
 	uint32_t		transHopNodeID;
 	uint32_t		nonce;
 	list<uint32_t> 	visitedNodeIDs;
 	list<double>	channelQualities;
+	list<double>	nodeWeights;    // of the visited nodes, empty unless advertised
 	bool			end;
 };
 
 struct EchoInfo {
 	uint32_t		sourceNodeID;
 	uint32_t 		seqNum;
+	bool			hasNodeWeight;
+	double			nodeWeight;     // of the source, refreshing it between route discoveries
+};
+
+struct Route;
+struct RoutesPerPair;
+
+// A directed link shared by all routes traversing it, so that a quality update
+// is a single write into the route stores of the dependent routes.
+struct Link {
+	uint32_t 							fromNodeID;
+	uint32_t 							toNodeID;
+	double 								quality;
+	ns3::Time							updateTime;   // when a quality other than broken was last heard for it
+	unordered_map<Route*, uint32_t> 	routes;   // dependent route -> hop index of the link
 };
 
 struct Route {
 	uint32_t 		id;
 	uint32_t 		n_hops;
-	list<uint32_t> 	nodeIDs;
-	list<double> 	channelQualities;
+	uint32_t		slot;    // row of the route in routesPerPair->store
+	vector<Link*> 	links;
 	ns3::Time 		updateTime;
 	double			metric;
+	bool			dirty;
+	RoutesPerPair*	routesPerPair;
+};
+
+// orders routes by descending metric, and by ascending id among equal metrics
+struct RouteRankOrder {
+	bool operator()(const Route* a, const Route* b) const {
+		if (a->metric != b->metric) return a->metric > b->metric;
+		return a->id < b->id;
+	}
+};
+
+// Routes of a pair in a structure-of-arrays layout: the node IDs of a route take a
+// fixed-capacity row of one array, and the log-qualities of its links a slot in the
+// hop-major columns of another, so that all metrics are computed in one pass.
+class RouteStore {
+public:
+	RouteStore();
+	uint32_t addRoute(list<uint32_t>& nodeIDs_route);
+	void removeRoute(uint32_t slot);
+	const uint32_t* getNodeIDs(uint32_t slot);
+	uint32_t getNNodes(uint32_t slot);
+	bool isRouteEqual(uint32_t slot, list<uint32_t>& nodeIDs_route);
+	bool containsNode(uint32_t slot, uint32_t nodeID);
+	void setLinkQuality(uint32_t slot, uint32_t hop, double quality);
+	void computeMetrics(double hopWeight);
+	double getMetric(uint32_t slot);
+	size_t countRoutes();
+	size_t getMemoryUsage();
+	static float computeMetric(list<double>& qualities, double hopWeight);
+
+private:
+	void reserve(uint32_t capacity_new);
+	static float toLogQuality(double quality);
+	static float toMetric(float logQualitySum, uint32_t nNodes, double hopWeight);
+
+	uint32_t		capacity;
+	uint32_t		nRoutes;
+	uint32_t		nLinksMax;
+	vector<uint32_t>	nodeIDs;        // [slot * ROUTE_MAX_NODES + i]
+	vector<uint8_t>		nNodes;         // [slot]
+	vector<float>		logQualities;   // [hop * capacity + slot], -inf if broken
+	vector<float>		metrics;        // [slot]
 };
 
 struct RoutesPerPair {
-	uint32_t 		consumerNodeID;
-	string 			producerPrefix;
-	vector<Route*> 	routes;
-	ns3::Time 		lastHitTime;
+	uint32_t 					consumerNodeID;
+	uint32_t 					producerPrefixID;
+	vector<Route*> 				routes;         // indexed by slot
+	set<Route*, RouteRankOrder>	routes_ranked;
+	vector<Route*>				routes_dirty;
+	RouteStore					store;
+	ns3::Time 					lastHitTime;
+	list<RoutesPerPair*>::iterator	lruPos;    // in RntpStrategy::routesPerPair_lru
+	uint32_t					n_hops_min;     // of the shortest route discovered for the pair
 };
 
-typedef vector<RoutesPerPair*> route_table;
+typedef unordered_map<uint64_t, RoutesPerPair*> route_table;   // keyed by getFlowKey()
+
+// Maps the producer prefixes seen by a node to dense IDs. A prefix is interned once
+// when first decoded, after which names are matched by their components.
+class PrefixInterner {
+public:
+	uint32_t intern(const Name& name);
+	uint32_t intern(const string& prefix);
+	const string& getPrefix(uint32_t prefixID);
+	size_t countPrefixes();
+
+private:
+	vector<Name> 						names;
+	vector<string> 						prefixes;
+	unordered_map<string, uint32_t> 	prefixIDs;
+};
 
 
 struct CapsuleToSend {
@@ -117,54 +218,120 @@ struct CapsuleToSend {
 	bool hidden;
 };
 
+struct CapsuleQueueNode {
+	CapsuleToSend 		element;
+	bool				isRestored;   // ready again after a timeout, so in the restored list
+	CapsuleQueueNode*	prev;
+	CapsuleQueueNode*	next;
+};
+
+// Capsules waiting to be sent and sent but not yet acknowledged (in-flight, i.e., hidden), kept
+// in intrusive lists indexed by data ID so that every operation is O(1). Those waiting are split
+// into the ones restored after a timeout and the fresh ones (ready), each in FIFO order, and the
+// restored ones are sent first.
 class CapsuleQueue {
 private:
-    std::list<CapsuleToSend> buffer;
+	struct NodeList {
+		CapsuleQueueNode* head = NULL;
+		CapsuleQueueNode* tail = NULL;
+	};
+
+	void insertAfter(NodeList& nodeList, CapsuleQueueNode* pos, CapsuleQueueNode* node);
+	void unlink(NodeList& nodeList, CapsuleQueueNode* node);
+	NodeList& getWaitingList(CapsuleQueueNode* node);
+
+	NodeList 										restored;
+	NodeList 										ready;
+	NodeList 										inflight;
+	unordered_map<uint32_t, CapsuleQueueNode*> 		nodesByDataID;
 
 public:
     CapsuleQueue();
+    ~CapsuleQueue();
     void removeElement(int id);
     void pushElement(CapsuleToSend& element);
     void transientlyPopElement();
+    void transientlyPopElement(uint32_t dataID);
     CapsuleToSend* restoreElement(int id);
+    CapsuleToSend* getElement(uint32_t dataID);
     CapsuleToSend* getFront();
+    CapsuleToSend* getNextReady(CapsuleToSend* element);
     size_t countElements();
     void setNodeID(uint32_t nodeID);
     bool isDataIDInBuffer(uint32_t dataID);
     void logBuffer();
     uint32_t nHiddenElements;
     uint32_t nodeID;
-    unordered_set<uint32_t> dataIDsInBuffer;
+
+    static bool enableLog;
 };
 
-struct ThroughputElement {
-    uint32_t secs;
-    uint32_t packet_count;
+struct CachedCapsule {
+	uint64_t	flowKey;
+	CapsuleInfo	capInfo;
+	Data		data;
+	bool		isReferenced;   // hit since the clock hand last passed it
 };
 
-class ThroughputQueue {
+// Capsules acknowledged by the next hop, kept by a relay so that a repair asked from downstream
+// is served here rather than from the producer. Bounded to a number of capsules over all flows,
+// and evicted by CLOCK: the hand passes the slots in turn, and a capsule hit since its last pass
+// gets a second chance.
+class CapsuleCache {
 public:
-    ThroughputQueue(size_t size);
-    ~ThroughputQueue();
-
-    void recordPacketArrival(ns3::Time time);
-    ns3::Time estimateLongestPIAT(double confidentRatio, ns3::Time maxPIAT);
+	CapsuleCache();
+	void setCapacity(size_t capacity);
+	void insert(uint64_t flowKey, CapsuleInfo& capInfo, const Data& data);
+	CachedCapsule* lookup(uint64_t flowKey, uint32_t dataID);
+	size_t countElements();
+	size_t getCapacity();
+
+	uint64_t nInserted;
+	uint64_t nEvicted;
+	uint64_t nHits;
+	uint64_t nMisses;
 
 private:
-    double countPacketMeanArrivalRate();
-    void enqueue(ThroughputElement item);
-    ThroughputElement dequeue();
-    ThroughputElement* rear();
-    bool isEmpty();
-    bool isFull();
-    size_t size();
+	size_t evict();
+
+	vector<CachedCapsule>											slots;
+	unordered_map<uint64_t, unordered_map<uint32_t, size_t> >		slotsByFlow;   // flow key -> data ID -> slot
+	size_t															hand;
+	size_t															capacity;
+};
+
+// Phi-accrual failure detection over the inter-arrival times of a neighbor's messages. The
+// neighbor is taken as gone after the silence that, under a normal fitted to the last inter-arrival
+// times, is exceeded with a chance of 10^-phi. A neighbor carrying capsules or ACKs is fitted on
+// their gaps alone and given a threshold of a few of them, whereas an Echo-only neighbor is never
+// given less than minSilence. As losses come in bursts the normal does not fit, the silence is never
+// shorter than a given number of mean inter-arrival times either.
+class LivenessDetector {
+public:
+    LivenessDetector(size_t size, double phiThreshold, ns3::Time minStdDev, ns3::Time echoPeriod);
+
+    void recordPacketArrival(ns3::Time time, bool isData);
+    bool isCarryingData();   // a capsule or ACK heard within an Echo period before the last message
+    ns3::Time getLastArrival();
+    ns3::Time estimateSilenceThreshold(double minIntervals, ns3::Time minSilence, ns3::Time maxSilence);
 
 private:
-    ThroughputElement* buffer;
-    size_t capacity;
-    size_t frontIndex;
-    size_t rearIndex;
-    size_t count;
+    struct IntervalWindow {
+        vector<double> 	intervals;   // in seconds, as a ring buffer
+        size_t 			next;
+    };
+    void addInterval(IntervalWindow& window, double interval);
+
+    IntervalWindow 	all;
+    IntervalWindow 	data;   // between two capsules or ACKs in a row
+    size_t 			capacity;
+    double 			z;   // of the standard normal at the phi threshold
+    double 			minStdDev;
+    ns3::Time 		echoPeriod;
+    ns3::Time 		lastArrival;
+    bool 			hasArrival;
+    ns3::Time 		lastDataArrival;
+    bool 			hasDataArrival;
 };
 
 
@@ -173,39 +340,339 @@ struct InterestBroadcastStates {
 	uint32_t nonce;
 };
 
+// A relay's InterestBroadcast still to be sent, with how far and how well it has come, and the
+// neighbors overheard sending the same flow's broadcast from no further and no worse.
+struct PendingInterestBroadcast {
+	InterestBroadcastInfo* 		info;
+	ns3::EventId 				sendEvent;
+	uint32_t 					hopCount;
+	double 						worstQuality;
+	unordered_set<uint32_t> 	coveringNodeIDs;
+};
+
+// Per-node pool of objects carved from slabs of OBJECT_POOL_SLAB_SIZE, so that states created
+// and dropped per capsule or per broadcast reuse memory instead of going through the heap.
+#define OBJECT_POOL_SLAB_SIZE		64
+
+template <class T>
+class ObjectPool {
+public:
+	ObjectPool() : nInUse(0), nInUse_highWater(0) {}
+
+	~ObjectPool() {
+		for (void* slab : slabs) {
+			::operator delete(slab);
+		}
+	}
+
+	T* acquire() {
+		if (freeObjs.empty()) {
+			T* slab = static_cast<T*>(::operator new(sizeof(T) * OBJECT_POOL_SLAB_SIZE));
+			slabs.push_back(slab);
+			for (int i = OBJECT_POOL_SLAB_SIZE - 1; i >= 0; --i) {
+				freeObjs.push_back(slab + i);
+			}
+		}
+		T* obj = freeObjs.back();
+		freeObjs.pop_back();
+		if (++nInUse > nInUse_highWater) {
+			nInUse_highWater = nInUse;
+		}
+		return new (obj) T();
+	}
+
+	void release(T* obj) {
+		obj->~T();
+		freeObjs.push_back(obj);
+		--nInUse;
+	}
+
+	size_t countInUse() { return nInUse; }
+	size_t countHighWater() { return nInUse_highWater; }
+	size_t getMemoryUsage() {
+		return slabs.size() * sizeof(T) * OBJECT_POOL_SLAB_SIZE + freeObjs.capacity() * sizeof(T*);
+	}
+
+private:
+	vector<void*> 	slabs;
+	vector<T*> 		freeObjs;
+	size_t 			nInUse;
+	size_t 			nInUse_highWater;
+};
+
+struct TimerWheelEntry {
+	uint64_t 				id;
+	uint64_t 				expiryTick;
+	uint32_t 				level;
+	uint32_t 				slot;
+	std::function<void()> 	callback;
+	TimerWheelEntry* 		prev;
+	TimerWheelEntry* 		next;
+};
+
+#define TIMER_WHEEL_LEVELS			4
+#define TIMER_WHEEL_SLOT_BITS		6
+#define TIMER_WHEEL_SLOTS			(1 << TIMER_WHEEL_SLOT_BITS)
+#define TIMER_WHEEL_NONE			UINT64_MAX
+
+// Per-node hierarchical timer wheel of TIMER_WHEEL_LEVELS levels, each of TIMER_WHEEL_SLOTS
+// slots a level coarser than the one below. It is driven by a single ns-3 event, kept at
+// the next tick that has timers due or has to cascade timers down from a coarser level.
+class TimerWheel {
+public:
+	TimerWheel();
+	~TimerWheel();
+	void setTick(ns3::Time tick);
+	uint64_t schedule(ns3::Time delay, std::function<void()> callback);
+	void cancel(uint64_t timerID);
+	bool isPending(uint64_t timerID);
+	size_t countPending();
+
+	uint64_t nTimersScheduled;
+	uint64_t nTimersCancelled;
+	uint64_t nTimersFired;
+	uint64_t nTickEvents;
+	uint64_t nTickEventsScheduled;   // with those cancelled, which stay in the ns-3 scheduler until due
+	size_t	 nTimersPending_highWater;
+
+private:
+	uint64_t getCurrentTick();
+	void place(TimerWheelEntry* entry);
+	void unlink(TimerWheelEntry* entry);
+	void cascade(uint32_t level, uint64_t tick);
+	bool isCascading(uint64_t tick);
+	uint64_t findNextTick();
+	void scheduleTickEvent(uint64_t tick);
+	void onTick();
+
+	int64_t 									tick_ns;
+	uint64_t 									tick_cur;   // every timer due at or before it has fired
+	uint64_t 									tick_scheduled;
+	ns3::EventId 								tickEvent;
+	TimerWheelEntry* 							slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+	unordered_map<uint64_t, TimerWheelEntry*> 	entriesByID;
+	ObjectPool<TimerWheelEntry> 				entryPool;
+	uint64_t 									id_next;
+};
+
 struct SendCapState {
-	ns3::EventId 				sendEventID;
+	uint64_t 					sendTimerID;   // in RntpStrategy::timerWheel
+	bool						isStriped;
+	uint32_t					stripeRouteID;
+	int							nextHopID;   // the in-flight capsule is counted against its window, -1 if none
+	ns3::Time					sendTime;   // of the last transmission
 	uint32_t 					sendTimes;
 	unordered_set<uint32_t> 	nodeIDs_down;
 };
 
+// Data IDs sent (or acknowledged) towards one next hop, as a bitmap over the last
+// `size` data IDs; the window slides forward with the highest data ID inserted.
+class DataIDWindow {
+public:
+	DataIDWindow(uint32_t size);
+	bool contains(uint32_t dataID);
+	void insert(uint32_t dataID);
+	bool erase(uint32_t dataID);
+	bool isErasable(uint32_t dataID);
+	size_t getMemoryUsage();
+
+private:
+	void slideTo(uint32_t base_new);
+
+	uint32_t 			base;
+	uint32_t 			nBits;
+	vector<uint64_t> 	words;
+};
+
+// A route the producer stripes capsules over, with its capsules in flight and a moving
+// average of how many of them were delivered without retransmission.
+struct StripePath {
+	uint32_t 	nInFlight;
+	double 		deliveryRate;
+};
+
+// A capsule the consumer found missing below the highest data ID it received.
+struct MissingCapsule {
+	ns3::Time	lastTime;   // when it was found missing or last asked for
+	uint32_t	nRepairsSent;
+};
+
+// Congestion state of a flow towards one next hop; the window bounds the capsules in flight on it.
+struct NextHopWindow {
+	int			window;
+	int 		slowStartThres;
+	uint32_t	nInFlight;
+	// per-hop ACK measurements, zero until sampled
+	ns3::Time	rtt_smooth;
+	ns3::Time	rtt_min;
+	ns3::Time	rtt_minStamp;
+	double		deliveryRate_max;   // in capsules per second
+	ns3::Time	deliveryRate_stamp;
+	uint32_t	nDelivered_round;
+	ns3::Time	round_start;
+	ns3::Time	adjustTime;   // of the last once-per-RTT adjustment
+};
+
+// Retransmission timeout towards one neighbor, estimated from its per-hop ACK RTTs as in RFC 6298.
+struct RtoEstimator {
+	ns3::Time	rtt_smooth;   // zero until sampled
+	ns3::Time	rtt_var;
+	ns3::Time	rto;
+	uint32_t	nSamples;
+};
+
+#define RTO_ALPHA						0.125
+#define RTO_BETA						0.25
+#define RTO_K							4
+#define RTO_CLOCK_GRANULARITY_IN_SECS	0.001
+
 struct TransportStates {
-	string									prefix;
+	uint32_t								prefixID;
 	uint32_t 								consumerID;
 	InterestBroadcastStates*				receivedInterestBroadcasts;
-	unordered_set<uint64_t> 				sentDataIDAndNextHops;
+	unordered_map<uint32_t, DataIDWindow> 	sentDataIDsPerNextHop;
+	unordered_map<uint32_t, StripePath> 	stripePaths;   // keyed by route ID
 	unordered_map<uint32_t, SendCapState*> 	sendCapStates;
-	int										window;
-	int 									slowStartThres;
+	unordered_map<uint32_t, NextHopWindow> 	windowsPerNextHop;
+	unordered_set<uint32_t>					nextHopsAwaited;   // whose full windows held capsules back, until woken
+	bool									isRouteAwaited;   // capsules were held back for want of a route
+	ns3::Time								lastAckTime;
+	unordered_map<uint32_t, uint64_t> 		pendingForwards;   // data ID -> backoff timer ID
+	double									ackInterval_smooth;   // in seconds, 0 until measured
 	CapsuleQueue							capSendQueue;
+	bool									isDataIDSeen;   // at the consumer, which tracks the gaps below the highest
+	uint32_t								dataID_highest;
+	unordered_map<uint32_t, MissingCapsule>	dataIDsMissing;
+	list<uint32_t>							upstreamNodeIDs_repair;   // of the latest capsule, asked for repairs
+	bool									isRepairTimerSet;
+	uint64_t								repairTimerID;
+};
+
+// What is observed of the link from a neighbor to this node, kept for every link estimator.
+struct LinkEstimate {
+	double		snr_smooth;
+	double		echoPrr;   // Echoes delivered, as a moving average over the gaps in their sequence numbers
+	bool		isEchoSeen;
+	uint32_t	echoSeqNum_last;
+	double		ackPrr;   // transmissions to the neighbor acknowledged, over both directions of the link
+	uint32_t	nAckSamples;
+};
+
+#define LINK_PRR_ALPHA			0.1
+#define LINK_PRR_MAX_GAP		64
+
+// Turns the observations of a link into its quality, which route metrics multiply along a route:
+// the moving average of the SNR (snr), the inverse of the ETX from Echo and capsule ACK deliveries
+// (etx), or the SNR weighted by that delivery ratio (hybrid).
+class RntpLinkEstimator {
+public:
+	static RntpLinkEstimator* create(string name);
+	virtual ~RntpLinkEstimator() {}
+	virtual string getName() = 0;
+	virtual double getQuality(LinkEstimate& e) = 0;
+	// the quality a node puts in the InterestBroadcasts it forwards for the link it was heard on
+	virtual double getAdvertisedQuality(LinkEstimate& e, double snr);
+
+	void init(LinkEstimate& e, double snr);
+	void onReceive(LinkEstimate& e, NodeInfo* nodeInfo, double snr);
+	void onEchoReceived(LinkEstimate& e, uint32_t seqNum);
+	void onCapAckResult(LinkEstimate& e, bool isAcked);
+
+protected:
+	double getDeliveryRatio(LinkEstimate& e);
+};
+
+class SnrLinkEstimator : public RntpLinkEstimator {
+public:
+	string getName();
+	double getQuality(LinkEstimate& e);
+	double getAdvertisedQuality(LinkEstimate& e, double snr);
+};
+
+class EtxLinkEstimator : public RntpLinkEstimator {
+public:
+	string getName();
+	double getQuality(LinkEstimate& e);
+};
+
+class HybridLinkEstimator : public RntpLinkEstimator {
+public:
+	string getName();
+	double getQuality(LinkEstimate& e);
 };
 
 struct ChannelQualityStates {
 	uint32_t 			fromNodeID;
-	double 				quality_smooth;
-	ns3::EventId 		waitMsgEvent;
-	ThroughputQueue* 	thQueue;
+	double 				quality_smooth;   // as estimated by RntpStrategy::linkEstimator
+	LinkEstimate		estimate;
+	uint64_t 			waitMsgTimerID;
+	ns3::Time 			waitMsgTimerExpiry;
+	ns3::Time 			waitMsgDeadline;   // pushed forward by every message, checked when the timer fires
+	LivenessDetector* 	liveness;
 };
 
+// Per-next-hop windows and ACK measurements shared by the algorithms, which decide how a window
+// grows on ACKs (onAck) and, if they differ from AIMD, how it reacts to timeouts.
 class RntpCongestionControl {
 public:
-	void init(TransportStates* ts,  NodeInfo* nodeInfo);
-	void onCapAckReceived(TransportStates* ts,  NodeInfo* nodeInfo);
+	static RntpCongestionControl* create(string algorithm);
+	virtual ~RntpCongestionControl() {}
+	virtual string getName() = 0;
+
+	NextHopWindow& getWindow(TransportStates* ts,  NodeInfo* nodeInfo, uint32_t nextHopID);
+	bool isWindowAvailable(TransportStates* ts,  NodeInfo* nodeInfo, uint32_t nextHopID);
+	void onCapSent(TransportStates* ts,  NodeInfo* nodeInfo, uint32_t nextHopID);
+	void onCapReleased(TransportStates* ts, uint32_t nextHopID);
+	void onCapAckReceived(TransportStates* ts,  NodeInfo* nodeInfo, uint32_t nextHopID, ns3::Time rtt);
+	virtual void onCapAckTimeout(TransportStates* ts,  NodeInfo* nodeInfo, int nextHopID);
+	void log(string reason, TransportStates* ts,  NodeInfo* nodeInfo, int nextHopID);
+
+protected:
+	virtual void onAck(NextHopWindow& w, NodeInfo* nodeInfo) = 0;
+	void measure(NextHopWindow& w, ns3::Time rtt);
+};
+
+// slow start, then additive increase; timeouts halve the window
+class AimdCongestionControl : public RntpCongestionControl {
+public:
+	string getName();
+
+protected:
+	void onAck(NextHopWindow& w, NodeInfo* nodeInfo);
+};
+
+// Delay-gradient control after TCP Vegas: once per RTT, the window grows while fewer than
+// VEGAS_ALPHA capsules queue up along the hop and shrinks beyond VEGAS_BETA.
+class VegasCongestionControl : public RntpCongestionControl {
+public:
+	string getName();
+
+protected:
+	void onAck(NextHopWindow& w, NodeInfo* nodeInfo);
+};
+
+// Rate-based control after BBR: the window follows the hop's bandwidth-delay product, from the
+// max-filtered delivery rate and the min-filtered RTT; a lone timeout is taken as channel loss.
+class BbrCongestionControl : public RntpCongestionControl {
+public:
+	string getName();
 	void onCapAckTimeout(TransportStates* ts,  NodeInfo* nodeInfo, int nextHopID);
-	void onChannelWaken(TransportStates* ts,  NodeInfo* nodeInfo, int fromNodeID);
-	void log(string reason, TransportStates* ts,  NodeInfo* nodeInfo);
+
+protected:
+	void onAck(NextHopWindow& w, NodeInfo* nodeInfo);
 };
 
+#define CONGESTION_RTT_ALPHA			0.125
+#define CONGESTION_RTT_MIN_FILTER_IN_SECS	10.0
+
+#define VEGAS_ALPHA						2
+#define VEGAS_BETA						4
+#define VEGAS_GAMMA						1
+
+#define BBR_CWND_GAIN					2.0
+#define BBR_MIN_WINDOW					4
+#define BBR_BW_FILTER_ROUNDS			10
+
 struct SendCapsuleIterParam {
 	uint32_t nTimesRetried;
 	uint32_t transHopNodeID_prev;
@@ -223,6 +690,11 @@ struct SendCapsuleIterParam {
 #define SEND_CAP_FROM_PERVIOUS_HOP   	   1
 #define SEND_CAP_FOR_RETRYING			   2
 
+// ready capsules passed over for a full window before sendCapsulesInQueue gives up on the queue
+#define SEND_QUEUE_SCAN_MAX_SKIPPED		  64
+
+#define PACING_ACK_INTERVAL_ALPHA		  0.125
+
 #define CAP_ARRIVAL_FROM_UPSTREAM			0
 #define CAP_ARRIVAL_FROM_DOWNSTREAM			1
 #define CAP_ARRIVAL_FROM_OTHERS				2
@@ -245,52 +717,115 @@ public:
     void onReceiveInterestBroadcast(const FaceEndpoint& ingress, const Data& data);
     void onReceiveCapsuleAck(const FaceEndpoint& ingress, const Data& data);
     void onReceiveEcho(const FaceEndpoint& ingress, const Data& data);
+    void onReceiveCapsuleRepair(const FaceEndpoint& ingress, const Data& data);
 
-    void propagateInterests(InterestBroadcastStates* rreqStates, string producerPrefix,
-    						list<uint32_t>& visitedNodeIDs, list<double>& channelQualities,
+    void propagateInterests(InterestBroadcastStates* rreqStates, uint32_t producerPrefixID,
+    						list<uint32_t>& visitedNodeIDs, list<double>& channelQualities, list<double>& nodeWeights,
     						uint32_t consumerNodeID, uint32_t initialHopCount, bool end);
 
+    bool shouldRebroadcastInterest();
+    void overhearInterestBroadcast(InterestBroadcastInfo& info);
     void propagateInterestsAsync(InterestBroadcastInfo* info, shared_ptr<Data> data, uint32_t times);
 
     int sendCapsule(TransportStates* ts, CapsuleInfo& capInfo, uint32_t transHopNodeID_prev,
     				const Data& data, uint32_t nTimesRetried, int code);
     int sendCapsuleIterative(TransportStates* ts, CapsuleInfo& capInfo, const Data& data, SendCapsuleIterParam params);
-    void sendCapsuleACK(string prefix, list<uint32_t>& dataIDsReceived, uint32_t downstreamNodeID,
+    void sendCapsuleACK(uint32_t prefixID, list<uint32_t>& dataIDsReceived, uint32_t downstreamNodeID,
     					list<uint32_t> upstreamNodeIDs, uint32_t transHopNodeID, uint32_t consumerNodeID);
     bool checkIfCapsuleArrivedInDownstream(CapsuleInfo& capInfo);
     int checkCapsuleArrivalDirection(CapsuleInfo& capInfo);
     unordered_set<uint32_t> sendCapsulesInQueue(TransportStates* ts);
+    unordered_set<uint32_t> sendReadyCapsules(TransportStates* ts, uint32_t nMax, size_t* nBytesSent);
+    unordered_set<uint32_t> sendCapsulesPaced(TransportStates* ts);
+    void onPacingTimer();
+    void enqueuePacedFlow(TransportStates* ts);
+    void schedulePacingEvent();
+    ns3::Time getPacingInterval(TransportStates* ts, size_t nBytes);
+    void updateAckInterval(TransportStates* ts);
     void sendCapsuleViaQueue(TransportStates* ts, CapsuleInfo& capInfo, const Data& data,
     								int code);
-    uint64_t hashDataIDAndNextHopID(uint32_t dataID, uint32_t nextHopID);
-    uint64_t getHash(CapsuleInfo& capInfo);
+    bool isDataIDSent(TransportStates* ts, uint32_t dataID, uint32_t nextHopID);
+    void markDataIDSent(TransportStates* ts, uint32_t dataID, uint32_t nextHopID);
     int getNextHop(list<uint32_t>& nodeIDs);
+    int getNextHop(Route* route);
+    list<uint32_t> getRouteNodeIDs(Route* route);
     int dealWithAck(TransportStates* ts, uint32_t dataID, uint32_t downstreamNodeID, uint32_t transNodeID, uint32_t reason);
-
-    void refreshRouteMetric(uint32_t consumerNodeID, string producerPrefix);
-    Route* lookupRoute(uint32_t consumerNodeID, string producerPrefix,
+    void releaseSendCapState(TransportStates* ts, uint32_t dataID);
+    void forwardOpportunistically(TransportStates* ts, CapsuleInfo& capInfo, const Data& data);
+    bool suppressPendingForward(TransportStates* ts, uint32_t dataID);
+    void updateRetransmissionTimeout(uint32_t neighborID, ns3::Time rtt);
+    ns3::Time getRetransmissionTimeout(int nextHopID, uint32_t sendTimes);
+    void trackCapsuleGaps(TransportStates* ts, CapsuleInfo& capInfo);
+    void scheduleCapsuleRepair(TransportStates* ts);
+    void onCapsuleRepairTimer(TransportStates* ts);
+    void sendCapsuleRepair(uint32_t prefixID, list<uint32_t>& dataIDsMissing, uint32_t requesterNodeID,
+    					list<uint32_t>& upstreamNodeIDs, uint32_t consumerNodeID);
+    void cacheCapsule(TransportStates* ts, uint32_t dataID);
+    bool serveCapsuleRepair(TransportStates* ts, uint32_t dataID);
+
+    RoutesPerPair* findRoutesPerPair(uint32_t consumerNodeID, uint32_t producerPrefixID);
+    void refreshRouteMetrics(RoutesPerPair* routesPerPair);
+    Route* chooseRoute(TransportStates* ts, CapsuleInfo& capInfo, int code, uint32_t nTimesRetried,
+    					bool canStripe, bool* isStriped);
+    Route* selectStripedRoute(TransportStates* ts, uint32_t consumerNodeID, uint32_t producerPrefixID);
+    void updateStripePath(TransportStates* ts, SendCapState* tranState, bool isDelivered);
+    Route* lookupRoute(uint32_t consumerNodeID, uint32_t producerPrefixID,
     					list<uint32_t>* nodeIDs_prev, uint32_t rank);
-    Route* matchRoute(uint32_t consumerNodeID, string producerPrefix, list<uint32_t> nodeIDs, list<uint32_t>* nodeIDs_prev);
-    void dumpRoute(uint32_t consumerNodeID, string producerPrefix);
-    void addRoute(string producerPrefix, uint32_t consumerNodeID, uint32_t n_hops,
+    Route* matchRoute(uint32_t consumerNodeID, uint32_t producerPrefixID, list<uint32_t> nodeIDs, list<uint32_t>* nodeIDs_prev);
+    void dumpRoute(uint32_t consumerNodeID, uint32_t producerPrefixID);
+    void addRoute(uint32_t producerPrefixID, uint32_t consumerNodeID, uint32_t n_hops,
     					list<uint32_t>& nodeIDs, list<double>& channelQualities);
+    bool isDiscoveredRouteAdmitted(uint32_t producerPrefixID, uint32_t consumerNodeID, uint32_t n_hops,
+    					list<double>& channelQualities);
+    bool isRouteWorthKeeping(RoutesPerPair* routesPerPair, list<uint32_t>& nodeIDs, list<double>& channelQualities);
+    void removeRoute(Route* route);
+    void removeRoutesPerPair(RoutesPerPair* routesPerPair);
+    void hitRoutesPerPair(RoutesPerPair* routesPerPair);
+    Route* selectRouteToEvict(RoutesPerPair* routesPerPair);
+    void enforceRouteTableBound();
+    void ageRoutes();
     double getWorstChannelQuality(list<double>& channelQualities);
     double getMeanChannelQuality(list<double>& channelQualities);
+    uint64_t hashLink(uint32_t fromNodeID, uint32_t toNodeID);
+    Link* getOrCreateLink(uint32_t fromNodeID, uint32_t toNodeID, double quality);
+    int setLinkQuality(Link* link, double channelQuality);
+    void applyLinkWeight(Link* link);
+    double getLinkWeight(Link* link);
+    double getLinkWeight(uint32_t toNodeID, double quality);
+    bool isNodeWeightAdvertised();
+    double getNodeWeight();
+    void learnNodeWeights(InterestBroadcastInfo& info);
+    void setNodeWeight(uint32_t nodeID, double weight);
     int updateRoutesWithQuality(uint32_t fromNodeID, uint32_t toNodeID, double channelQuality);
-    void updateChannelQuality(uint32_t fromNodeID, double quality);
+    void updateChannelQuality(uint32_t fromNodeID, double quality, bool isData);
+    bool isAwaitingMsgsFrom(uint32_t neighborID);
     list<uint32_t> getUpstreamNodeIDsFromCapsule(list<uint32_t> nodeIDs, uint32_t transHopNodeID);
 
     void markChannelBroken(uint32_t fromNodeID, string reason);
+    void onWaitMsgTimer(uint32_t fromNodeID);
+    void updateLinkDelivery(uint32_t neighborID, bool isDelivered);
 
     void sendEchoInPeriodical();
+    void sendEcho();
+    void resetEchoInterval();
+    void onMsgSent();
+
+    ns3::Time getNextDutyCycleSlot();
+    void onDutyCycleSlot();
+    void trySleepRadio();
+    void holdRadioAwake();
+    void setRadioAsleep(bool asleep);
     double findEquivalentQualityOfBestRoute(uint32_t upstreamNeighboredNodeID);
 
     set<uint32_t> getNeighboredIDsInRoutes();
-    set<uint32_t> getNeighboredIDsInRoutes(uint32_t consumerID, string prefix);
-    string hashPrefixAndConsumerID(string prefix, uint32_t consumerID);
+    set<uint32_t> getNeighboredIDsInRoutes(uint32_t consumerID, uint32_t prefixID);
+    void indexRouteNeighbor(Route* route, bool isAdded);
+    uint64_t getFlowKey(uint32_t prefixID, uint32_t consumerID);
+    TransportStates* createTransportStates(uint32_t prefixID, uint32_t consumerID);
+    void releaseTransportStates(TransportStates* ts);
     void addDownStreamNodes(unordered_set<uint32_t>* A, list<uint32_t>& B);
 
-    int32_t findPrefix(string prefix);
+    int32_t findPrefix(uint32_t prefixID);
 
     void sendLltcNonPitData(Data& data);
 
@@ -299,12 +834,14 @@ public:
     shared_ptr<Data> constructInterestBroadcast(InterestBroadcastInfo* info);
     shared_ptr<Data> constructCapsuleACK(CapsuleACKInfo& info);
     shared_ptr<Data> constructEcho(EchoInfo* info);
+    shared_ptr<Data> constructCapsuleRepair(CapsuleRepairInfo& info);
 
     void extractEcho(const Data& data, EchoInfo* info);
     void extractInterest(const Interest& interest, InterestInfo* info);
     void extractCapsuleInfo(const Data& data, CapsuleInfo* info);
     void extractInterestBroadcastInfo(const Data& data, InterestBroadcastInfo* info);
     void extractCapsuleACK(const Data& data, CapsuleACKInfo& info);
+    void extractCapsuleRepair(const Data& data, CapsuleRepairInfo& info);
     void extractRouteTag(const Data& data, RouteTagInfo* info);
     void extractRouteTag(const Interest& interest, RouteTagInfo* info);
     void writeRouteTag(const RouteTagInfo& info, Data& data);
@@ -319,21 +856,62 @@ public:
     void logMsgCapAck(bool isRecv, CapsuleACKInfo& info, PhyInfo* phyInfo);
     void logMsgEcho(bool isRecv, EchoInfo& info, PhyInfo* phyInfo);
     void logRoutes();
+    void logRouteTableStats();
+    void logMemory();
+    void logTimers();
+    void logOpportunisticForwarding();
+    void logRetransmissionTimeouts();
+    void logCapsuleCache();
 
     // map from node ID to a dict of <Message name, counter>
     static unordered_map<int, unordered_map<string, int>*> 	performance_res;
     static ns3::Ptr<ns3::UniformRandomVariable> 			rand;
     static bool												enableLog_msgs;
+    static uint64_t											nCapsuleRetransmissions;   // per-hop, over all nodes
+    static uint64_t											nEchoesSent;   // over all nodes
+    static uint64_t											nEchoesSuppressed;
+    static uint64_t											nLinksBrokenBySilence;   // over all nodes
+    static double											secsSilentBeforeBroken_total;   // since the neighbor's last message
+    static uint64_t											nInterestBroadcastsSent;   // over all nodes
+    static uint64_t											nInterestBroadcastsSuppressed;
+    static uint64_t											nInterestBroadcastsSkipped;
+    static uint64_t											nNodesReached;   // by InterestBroadcasts, per flow
+    static double											secsAsleep_total;   // of the radios, over all nodes
+    static uint64_t											nCapsuleRepairsRequested;   // data IDs, by all consumers
+    static uint64_t											nCapsuleRepairHits;   // served from a copy on the path
+    static uint64_t											nCapsuleRepairMisses;
+    static uint64_t											nCapsuleRepairHopsSaved;   // between the serving node and the producer
 
 private:
     void initializeFaces();
 
     NodeInfo* 										nodeInfo;
 
-    unordered_map<string, TransportStates*> 		transportStates_all;
+    PrefixInterner									prefixInterner;
+    vector<uint32_t>								localPrefixIDs;   // IDs of nodeInfo->prefixes, in order
+    unordered_map<uint64_t, TransportStates*> 		transportStates_all;   // keyed by getFlowKey()
+    ObjectPool<SendCapState>						sendCapStatePool;
+    ObjectPool<InterestBroadcastInfo>				interestBroadcastInfoPool;
+    TimerWheel										timerWheel;
 
     uint32_t 										route_id_cur;
     route_table 									routes_all;
+    list<RoutesPerPair*>							routesPerPair_lru;   // the least recently hit pair first
+    unordered_map<uint64_t, Link*>					links_all;
+    unordered_map<uint32_t, unordered_set<Link*> >	linksByToNodeID;
+    unordered_map<uint32_t, double>					nodeWeights_all;   // advertised in InterestBroadcasts, and by neighbors in Echoes
+    unordered_map<uint32_t, unordered_map<uint64_t, uint32_t> >	flowsPerNeighbor;   // neighbor ID -> flow key -> number of routes
+    uint32_t										nRoutes_total;
+    uint32_t										nRoutes_highWater;
+    uint32_t										nRoutesEvicted_cap;
+    uint32_t										nRoutesEvicted_idle;
+    uint32_t										nRoutesEvicted_stale;
+    uint32_t										nRoutesEvicted_bound;
+    uint32_t										nRoutesRejected_hops;
+    uint32_t										nRoutesRejected_length;
+    uint32_t										nRoutesRejected_quality;
+    uint32_t										nRoutesRejected_rank;
+    ns3::EventId									ageRoutesEvent;
 
     unordered_map<uint32_t, ChannelQualityStates> 	channelQualities;
     unordered_set<uint64_t> 						receivedChannelQualityUpdates;
@@ -341,14 +919,36 @@ private:
     bool											underPreparationToSendCQUpdate;
     uint32_t 										channelQualityUpdate_seqno_cur;
 
+    unordered_map<uint64_t, PendingInterestBroadcast>	pendingInterestBroadcasts;   // keyed by getFlowKey()
+
     ns3::EventId 									sendEchoEvent;
     uint32_t 										echo_seqnum;
+    ns3::Time 										echoInterval;   // doubled up to echoMaxPeriod with Trickle Echoes
+    ns3::Time 										lastSendTime;   // of any message neighbors hear from this node
+
+    bool											isRadioAsleep;
+    ns3::Time										sleepStartTime;
+    ns3::Time										awakeHoldUntil;   // while this node is on a live subpath or in a discovery
+    ns3::EventId									dutyCycleEvent;
+    ns3::EventId									sleepEvent;
 
     bool 											is_face_found;
     ::nfd::face::Face* 								face_netdev;
     ::nfd::face::Face* 								face_app;
 
     RntpCongestionControl*							congestionControl;
+    unordered_map<uint32_t, RtoEstimator>			rtoPerNeighbor;
+    RntpLinkEstimator*								linkEstimator;
+
+    uint32_t										nForwardsDeferred;
+    uint32_t										nForwardsSuppressed;
+
+    CapsuleCache									capsuleCache;
+
+    ns3::EventId 									pacingEvent;
+    ns3::Time 										pacingNextTime;   // when the channel is next free for a capsule
+    deque<uint64_t> 								pacedFlows;   // flow keys served round robin
+    unordered_set<uint64_t> 						pacedFlowKeys;
 };
 
 void initializeRntpStrategyRand();
@@ -12,6 +12,8 @@
 
 #include "utils/batches.hpp"
 
+#include <algorithm>
+
 NS_LOG_COMPONENT_DEFINE("ndn.GenericConsumer");
 
 using namespace ns3::ndn;
@@ -41,6 +43,20 @@ GenericConsumer::GenericConsumer()
 	n_recvCapsules = 0;
 	queue = NULL;
 	needToTerminateTransport = false;
+	codingEnabled = false;
+	generation_max = 0;
+	n_recvRepairs = 0;
+	n_decodedCapsules = 0;
+}
+
+GenericConsumer::~GenericConsumer() {
+	for (auto iter = decoders.begin(); iter != decoders.end(); ++iter) {
+		delete iter->second;
+	}
+}
+
+void GenericConsumer::setCoding(bool codingEnabled) {
+	this->codingEnabled = codingEnabled;
 }
 
 void GenericConsumer::setNodeID(uint32_t nodeID) {
@@ -116,8 +132,15 @@ void GenericConsumer::OnData(shared_ptr<const Data> data) {
 	this->extractCapsuleInfo(*data, &capInfo);
 	ofstream* log = RntpUtils::getLogConsumer();
 	logMsgCapsule(log, capInfo);
+	recvTimes.emplace(capInfo.dataID, Simulator::Now());
 	std::cout << "consumer recv Data with prefix " << capInfo.prefix << ", dataID: " << capInfo.dataID << ", time: " << Simulator::Now().GetSeconds() << std::endl;
 
+	if (codingEnabled && receiveCoded(capInfo, data)) {
+		ofstream* log_q = RntpUtils::getLogConsumerQueueSize();
+		*log_q << Simulator::Now() << "," << queue->getQueueSize() << endl;
+		return;
+	}
+
 	queue->receiveData(capInfo, data);
 	ofstream* log_q = RntpUtils::getLogConsumerQueueSize();
 	*log_q << Simulator::Now() << "," << queue->getQueueSize() << endl;
@@ -125,12 +148,83 @@ void GenericConsumer::OnData(shared_ptr<const Data> data) {
 	n_recvCapsules++;
 }
 
+// Feeds a coded capsule to the decoder of its generation. The sources it makes decodable go to
+// the resequencing before the capsule itself, so that a repair filling a gap releases what waits
+// behind it. Returns false if the capsule carries no coding header.
+bool GenericConsumer::receiveCoded(CapsuleInfoC& capInfo, shared_ptr<const Data> data) {
+	const uint8_t* content = data->getContent().value();
+	size_t contentSize = data->getContent().value_size();
+	RlncHeader header;
+	if (!readRlncHeader(content, contentSize, header)) {
+		return false;
+	}
+	const uint8_t* coefs = content + RLNC_HEADER_SIZE;
+	const uint8_t* payload = coefs + header.k;
+	size_t symbolSize = contentSize - RLNC_HEADER_SIZE - header.k;
+
+	if (header.generation + RLNC_MAX_PENDING_GENERATIONS <= generation_max) {
+		// too late to help decoding
+		capInfo.isRepair = header.flags & RLNC_FLAG_REPAIR;
+		queue->receiveData(capInfo, data);
+		if (!capInfo.isRepair) {
+			n_recvCapsules++;
+		}
+		return true;
+	}
+	if (header.generation > generation_max) {
+		generation_max = header.generation;
+		for (auto iter = decoders.begin(); iter != decoders.end();) {
+			if (iter->first + RLNC_MAX_PENDING_GENERATIONS <= generation_max) {
+				delete iter->second;
+				iter = decoders.erase(iter);
+			} else {
+				++iter;
+			}
+		}
+	}
+	RlncDecoder*& decoder = decoders[header.generation];
+	if (decoder == NULL) {
+		decoder = new RlncDecoder(header.k, symbolSize);
+	}
+
+	uint32_t dataID_base = capInfo.dataID - header.index;
+	vector<uint32_t> indices = decoder->addSymbol(coefs, payload);
+	for (uint32_t index : indices) {
+		if (index == header.index) {
+			continue;
+		}
+		CapsuleInfoC du = capInfo;
+		du.dataID = dataID_base + index;
+		du.isRepair = false;
+		this->logDecoded(du, header.generation);
+		queue->receiveData(du, data);
+		n_decodedCapsules++;
+		n_recvCapsules++;
+	}
+
+	if (header.flags & RLNC_FLAG_REPAIR) {
+		capInfo.isRepair = true;
+		queue->receiveData(capInfo, data);
+		n_recvRepairs++;
+	} else if (std::find(indices.begin(), indices.end(), header.index) != indices.end()) {
+		queue->receiveData(capInfo, data);
+		n_recvCapsules++;
+	}
+	return true;
+}
+
+void GenericConsumer::logDecoded(CapsuleInfoC& info, uint32_t generation) {
+	ofstream* log = RntpUtils::getLogConsumer();
+	*log << this->nodeID << "," << Simulator::Now() << ",r,Decoded," << info.prefix << "," << info.dataID << "," << generation << endl;
+}
+
 void GenericConsumer::extractCapsuleInfo(const Data& data, CapsuleInfoC* info) {
 	Name dataName = data.getName();
 	stringstream ss;
 	ss << "/" << dataName.get(0).toUri(name::UriFormat::DEFAULT) << "/" << dataName.get(1).toUri(name::UriFormat::DEFAULT);
 	info->prefix = ss.str();
 	info->dataID = stoull(dataName.get(3).toUri(name::UriFormat::DEFAULT));
+	info->isRepair = false;
 	if (dataName.size() >= 7) {
 		info->nonce = stoull(dataName.get(4).toUri(name::UriFormat::DEFAULT));
 		info->transHopNodeID = stoull(dataName.get(5).toUri(name::UriFormat::DEFAULT));
@@ -206,6 +300,18 @@ int32_t GenericConsumer::getNRecvCapsules() {
 	return n_recvCapsules;
 }
 
+int32_t GenericConsumer::getNRecvRepairs() {
+	return n_recvRepairs;
+}
+
+int32_t GenericConsumer::getNDecodedCapsules() {
+	return n_decodedCapsules;
+}
+
+const unordered_map<uint32_t, ns3::Time>& GenericConsumer::getRecvTimes() {
+	return recvTimes;
+}
+
 void GenericConsumer::onDataReseq(CapsuleInfoC du, shared_ptr<const Data> data) {
 	ofstream* log = RntpUtils::getLogConsumerReseq();
 	this->logMsgCapsule(log, du);
@@ -223,6 +329,11 @@ void RntpResequenceQueue::boundApp(GenericConsumer* app) {
 }
 
 void RntpResequenceQueue::receiveData(CapsuleInfoC du, shared_ptr<const Data> data) {
+	if (lastDataId != -1 && (int64_t) du.dataID <= lastDataId) {
+		// already given up on, e.g., a capsule decoded late, so it must not move the sequence back
+		sendData(du, data);
+		return;
+	}
 	if (lastDataId == -1) {
 		sendData(du, data);
 		lastDataId = du.dataID;
@@ -306,7 +417,7 @@ void RntpResequenceQueue::releaseQueue(ns3::Time curTime) {
 }
 
 void RntpResequenceQueue::sendData(CapsuleInfoC du, shared_ptr<const Data> data) {
-	if (this->app != NULL) {
+	if (this->app != NULL && !du.isRepair) {
 		this->app->onDataReseq(du, data);
 	}
 }
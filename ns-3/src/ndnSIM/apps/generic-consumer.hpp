@@ -6,6 +6,7 @@
 #include "ndn-consumer.hpp"
 #include "ns3/traced-value.h"
 #include "ns3/ndnSIM/utils/batches.hpp"
+#include "ns3/ndnSIM/model/rntp-coding.hpp"
 #include <string>
 #include <list>
 #include <unordered_map>
@@ -24,6 +25,7 @@ struct CapsuleInfoC {
 	list<uint32_t> 	nodeIDs;
 	uint32_t 		nonce;
 	uint32_t		nHops;
+	bool			isRepair;   // a coded capsule, only used to move the resequencing on
 };
 
 struct InterestBroadcastInfoC {
@@ -56,16 +58,23 @@ public:
 	static TypeId
 	GetTypeId();
 	GenericConsumer();
+	virtual ~GenericConsumer();
 	void setNodeID(uint32_t nodeID);
 	void setMaxWaitTime(ns3::Time maxWaitTime);
 	virtual void OnData(shared_ptr<const Data> contentObject);
 	int32_t getNRecvCapsules();
+	void setCoding(bool codingEnabled);
+	int32_t getNRecvRepairs();
+	int32_t getNDecodedCapsules();
+	const unordered_map<uint32_t, ns3::Time>& getRecvTimes();
 	void onDataReseq(CapsuleInfoC du, shared_ptr<const Data> data);
 	void extractCapsuleInfo(const Data& data, CapsuleInfoC* info);
 	shared_ptr<Data> constructInterestBroadcast(InterestBroadcastInfoC* info);
 	void logMsgCapsule(ofstream* log, CapsuleInfoC& info);
 	void setToTerminateTransport(ns3::Time delayToTerminate);
 	void terminateTransport();
+	bool receiveCoded(CapsuleInfoC& capInfo, shared_ptr<const Data> data);
+	void logDecoded(CapsuleInfoC& info, uint32_t generation);
 
 protected:
 	virtual void ScheduleNextPacket();
@@ -78,6 +87,12 @@ private:
 	ns3::Time 										maxWaitTime;
 	ns3::Time 										delayToTerminateTransport;
 	bool	  										needToTerminateTransport;
+	bool											codingEnabled;
+	unordered_map<uint32_t, RlncDecoder*>			decoders;   // by generation
+	uint32_t										generation_max;
+	int32_t											n_recvRepairs;
+	int32_t											n_decodedCapsules;
+	unordered_map<uint32_t, ns3::Time>				recvTimes;   // of the first arrival of each dataID
 	static ns3::Ptr<ns3::UniformRandomVariable> 	rand;
 };
 
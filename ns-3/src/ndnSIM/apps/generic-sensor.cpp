@@ -34,6 +34,12 @@ NS_OBJECT_ENSURE_REGISTERED(GenericSensorApp);
 GenericSensorApp::GenericSensorApp() {
 	n_CapsuleSent = 0;
 	dataId = 0;
+	codingEnabled = false;
+	codingK = 0;
+	codingN = 0;
+	generation = 0;
+	encoder = NULL;
+	n_RepairSent = 0;
 
 	rand = ns3::CreateObject<ns3::UniformRandomVariable>();
 	rand->SetAttribute ("Min", ns3::DoubleValue (1.0));
@@ -61,6 +67,8 @@ void GenericSensorApp::DoInitialize() {
 }
 
 void GenericSensorApp::DoDispose() {
+	delete encoder;
+	encoder = NULL;
 	App::DoDispose();
 }
 
@@ -72,6 +80,15 @@ void GenericSensorApp::setNodeID(uint32_t nodeID) {
 	this->nodeID = nodeID;
 }
 
+// every generation of k sources is followed by nRepairsPerGeneration random combinations of them
+void GenericSensorApp::setCoding(bool codingEnabled, uint32_t generationSize, uint32_t nRepairsPerGeneration) {
+	this->codingEnabled = codingEnabled && generationSize > 0;
+	codingK = generationSize > 255 ? 255 : generationSize;
+	codingN = codingK + nRepairsPerGeneration > 255 ? 255 : codingK + nRepairsPerGeneration;
+	delete encoder;
+	encoder = this->codingEnabled ? new RlncEncoder(codingK, GENERIC_SENSOR_PAYLOAD_SIZE) : NULL;
+}
+
 void GenericSensorApp::setFreq(int freq) {
 	piat = MicroSeconds(1000000.0 / (double) freq);
 }
@@ -99,11 +116,69 @@ void GenericSensorApp::OnInterest(std::shared_ptr<const Interest> interest) {
 }
 
 void GenericSensorApp::sendData(uint32_t consumerNodeID) {
+	if (codingEnabled) {
+		sendCodedData(consumerNodeID);
+	} else {
+		sendCapsule(consumerNodeID, std::make_shared< ::ndn::Buffer>(GENERIC_SENSOR_PAYLOAD_SIZE), false);
+	}
+	n_CapsuleSent++;
+
+	if (Simulator::Now() > m_stopTime) {
+		return;
+	}
+
+	double x = rand->GetValue(-1e3, 1e3);
+	ns3::Time interval = piat + ns3::NanoSeconds(x);
+	Simulator::Schedule(interval, &GenericSensorApp::sendData, this, consumerNodeID);
+}
+
+// Sources go out uncoded, with a unit coefficient vector, so that the consumer decodes nothing
+// unless a source is lost; the repairs follow the last source of the generation.
+void GenericSensorApp::sendCodedData(uint32_t consumerNodeID) {
+	size_t contentSize = RLNC_HEADER_SIZE + codingK + GENERIC_SENSOR_PAYLOAD_SIZE;
+	RlncHeader header;
+	header.generation = generation;
+	header.index = encoder->countSources();
+	header.k = codingK;
+	header.n = codingN;
+	header.flags = 0;
+
+	auto content = std::make_shared< ::ndn::Buffer>(contentSize);
+	uint8_t* coefs = content->data() + RLNC_HEADER_SIZE;
+	uint8_t* payload = coefs + codingK;
+	writeRlncHeader(content->data(), header);
+	coefs[header.index] = 1;
+	for (size_t i = 0; i < GENERIC_SENSOR_PAYLOAD_SIZE; ++i) {
+		payload[i] = (uint8_t) (dataId * 131 + i);
+	}
+	bool isFull = encoder->addSource(payload);
+	sendCapsule(consumerNodeID, content, false);
+	if (!isFull) {
+		return;
+	}
+
+	header.flags = RLNC_FLAG_REPAIR;
+	for (header.index = codingK; header.index < codingN; ++header.index) {
+		content = std::make_shared< ::ndn::Buffer>(contentSize);
+		coefs = content->data() + RLNC_HEADER_SIZE;
+		writeRlncHeader(content->data(), header);
+		for (uint32_t i = 0; i < codingK; ++i) {
+			coefs[i] = rand->GetInteger(1, 255);
+		}
+		encoder->encodeRepair(coefs, coefs + codingK);
+		sendCapsule(consumerNodeID, content, true);
+		n_RepairSent++;
+	}
+	encoder->reset();
+	++generation;
+}
+
+void GenericSensorApp::sendCapsule(uint32_t consumerNodeID, std::shared_ptr< ::ndn::Buffer> content, bool isRepair) {
 	stringstream ss;
 	ss << sensorName << "/Capsule/" << dataId;
 	auto data = std::make_shared<Data>(string(ss.str()));
 	data->setFreshnessPeriod(::ndn::time::milliseconds(1000));
-	data->setContent(std::make_shared< ::ndn::Buffer>(1024));
+	data->setContent(content);
 	uint64_t tagValue = ((uint64_t) consumerNodeID << 32) | (uint64_t) 0xffffffff;
 	data->setTag<::ndn::lp::LltcConsumerIdTag>(make_shared<::ndn::lp::LltcConsumerIdTag>(tagValue));
 	data->setTag<::ndn::lp::LltcPathIdTag>(make_shared<::ndn::lp::LltcPathIdTag>(0));
@@ -112,23 +187,17 @@ void GenericSensorApp::sendData(uint32_t consumerNodeID) {
 	m_transmittedDatas(data, this, m_face);
 	m_appLink->onReceiveData(*data);
 
-	GenericLog::TimeSendingData[dataId] = Simulator::Now();
-	GenericLog::dataID_sent.push_back(dataId);
-
 	ofstream* log = RntpUtils::getLogProducer();
-	*log << this->nodeID << "," << Simulator::Now() << ",s,Data," << dataId << "," << consumerNodeID << endl;
+	if (!isRepair) {
+		GenericLog::TimeSendingData[dataId] = Simulator::Now();
+		GenericLog::dataID_sent.push_back(dataId);
+		*log << this->nodeID << "," << Simulator::Now() << ",s,Data," << dataId << "," << consumerNodeID << endl;
+	} else {
+		*log << this->nodeID << "," << Simulator::Now() << ",s,Repair," << dataId << "," << consumerNodeID << endl;
+	}
 
 	cout << "GenericSensorApp: send data " << ss.str() << ", time: " << Simulator::Now() << endl;
 	++dataId;
-	n_CapsuleSent++;
-
-	if (Simulator::Now() > m_stopTime) {
-		return;
-	}
-
-	double x = rand->GetValue(-1e3, 1e3);
-	ns3::Time interval = piat + ns3::NanoSeconds(x);
-	Simulator::Schedule(interval, &GenericSensorApp::sendData, this, consumerNodeID);
 }
 
 
@@ -140,5 +209,9 @@ int32_t GenericSensorApp::getNCapsuleSent() {
 	return n_CapsuleSent;
 }
 
+int32_t GenericSensorApp::getNRepairSent() {
+	return n_RepairSent;
+}
+
 }
 
@@ -3,11 +3,14 @@
 
 #include "ns3/ndnSIM/apps/ndn-app.hpp"
 #include "ns3/random-variable-stream.h"
+#include "ns3/ndnSIM/model/rntp-coding.hpp"
 #include <string>
 #include <fstream>
 
 namespace generic {
 
+#define GENERIC_SENSOR_PAYLOAD_SIZE		1024
+
 class GenericSensorApp : public ns3::ndn::App {
 public:
 	static ns3::TypeId GetTypeId();
@@ -25,9 +28,13 @@ public:
 	void setSensorName(std::string sensorName);
 	void setNodeID(uint32_t nodeID);
 	int32_t getNCapsuleSent();
+	void setCoding(bool codingEnabled, uint32_t generationSize, uint32_t nRepairsPerGeneration);
+	int32_t getNRepairSent();
 
 private:
 	void sendData(uint32_t consumerNodeID);
+	void sendCodedData(uint32_t consumerNodeID);
+	void sendCapsule(uint32_t consumerNodeID, std::shared_ptr< ::ndn::Buffer> content, bool isRepair);
 
 	int dataId;
 	std::ofstream outLog_pmu;
@@ -36,6 +43,13 @@ private:
 	int32_t n_CapsuleSent;
 	uint32_t nodeID;
 	ns3::Ptr<ns3::UniformRandomVariable> rand;
+
+	bool codingEnabled;
+	uint32_t codingK;
+	uint32_t codingN;
+	uint32_t generation;
+	RlncEncoder* encoder;
+	int32_t n_RepairSent;
 };
 
 }
@@ -0,0 +1,305 @@
+/*
+ * This work is licensed under CC BY-NC-SA 4.0
+ * (https://creativecommons.org/licenses/by-nc-sa/4.0/).
+ * Copyright (c) 2025 Boyang Zhou
+ *
+ * This file is a part of "Subpath-Aware Reliable Transport Control Protocol (SART) for Wireless Multihop Networks"
+ * (https://github.com/zhouby-zjl/sart/).
+ * Written by Boyang Zhou (zhouby@zhejianglab.com / zby_zju@163.com)
+ *
+ */
+
+#include "rntp-coding.hpp"
+
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define RLNC_X86
+#endif
+
+using namespace std;
+
+bool Gf256::initialized = false;
+uint8_t Gf256::expTable[512];
+uint8_t Gf256::logTable[256];
+
+void Gf256::init() {
+	uint32_t x = 1;
+	for (uint32_t i = 0; i < 255; ++i) {
+		expTable[i] = x;
+		logTable[x] = i;
+		x <<= 1;
+		if (x & 0x100) {
+			x ^= 0x11d;
+		}
+	}
+	for (uint32_t i = 255; i < 512; ++i) {
+		expTable[i] = expTable[i - 255];
+	}
+	logTable[0] = 0;
+	initialized = true;
+}
+
+uint8_t Gf256::mul(uint8_t a, uint8_t b) {
+	if (!initialized) {
+		init();
+	}
+	if (a == 0 || b == 0) {
+		return 0;
+	}
+	return expTable[logTable[a] + logTable[b]];
+}
+
+uint8_t Gf256::inv(uint8_t a) {
+	if (!initialized) {
+		init();
+	}
+	return a == 0 ? 0 : expTable[255 - logTable[a]];
+}
+
+void Gf256::mulAddScalar(uint8_t* dst, const uint8_t* src, uint8_t c, size_t n) {
+	uint8_t row[256];
+	for (uint32_t x = 0; x < 256; ++x) {
+		row[x] = mul(c, x);
+	}
+	for (size_t i = 0; i < n; ++i) {
+		dst[i] ^= row[src[i]];
+	}
+}
+
+void Gf256::scale(uint8_t* dst, uint8_t c, size_t n) {
+	uint8_t row[256];
+	for (uint32_t x = 0; x < 256; ++x) {
+		row[x] = mul(c, x);
+	}
+	for (size_t i = 0; i < n; ++i) {
+		dst[i] = row[dst[i]];
+	}
+}
+
+#ifdef RLNC_X86
+
+// c * x is looked up per nibble with a byte shuffle: c * x = lo[x & 0xf] ^ hi[x >> 4]
+static void getNibbleTables(uint8_t c, uint8_t* lo, uint8_t* hi) {
+	for (uint32_t x = 0; x < 16; ++x) {
+		lo[x] = Gf256::mul(c, x);
+		hi[x] = Gf256::mul(c, x << 4);
+	}
+}
+
+__attribute__((target("ssse3")))
+static size_t mulAddSsse3(uint8_t* dst, const uint8_t* src, uint8_t c, size_t n) {
+	uint8_t lo[16], hi[16];
+	getNibbleTables(c, lo, hi);
+	__m128i t_lo = _mm_loadu_si128((const __m128i*) lo);
+	__m128i t_hi = _mm_loadu_si128((const __m128i*) hi);
+	__m128i mask = _mm_set1_epi8(0x0f);
+	size_t i = 0;
+	for (; i + 16 <= n; i += 16) {
+		__m128i x = _mm_loadu_si128((const __m128i*) (src + i));
+		__m128i p = _mm_xor_si128(_mm_shuffle_epi8(t_lo, _mm_and_si128(x, mask)),
+								  _mm_shuffle_epi8(t_hi, _mm_and_si128(_mm_srli_epi64(x, 4), mask)));
+		__m128i d = _mm_loadu_si128((const __m128i*) (dst + i));
+		_mm_storeu_si128((__m128i*) (dst + i), _mm_xor_si128(d, p));
+	}
+	return i;
+}
+
+__attribute__((target("avx2")))
+static size_t mulAddAvx2(uint8_t* dst, const uint8_t* src, uint8_t c, size_t n) {
+	uint8_t lo[16], hi[16];
+	getNibbleTables(c, lo, hi);
+	// the shuffle works within 128-bit lanes, so the tables are repeated in both
+	__m256i t_lo = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*) lo));
+	__m256i t_hi = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*) hi));
+	__m256i mask = _mm256_set1_epi8(0x0f);
+	size_t i = 0;
+	for (; i + 32 <= n; i += 32) {
+		__m256i x = _mm256_loadu_si256((const __m256i*) (src + i));
+		__m256i p = _mm256_xor_si256(_mm256_shuffle_epi8(t_lo, _mm256_and_si256(x, mask)),
+									 _mm256_shuffle_epi8(t_hi, _mm256_and_si256(_mm256_srli_epi64(x, 4), mask)));
+		__m256i d = _mm256_loadu_si256((const __m256i*) (dst + i));
+		_mm256_storeu_si256((__m256i*) (dst + i), _mm256_xor_si256(d, p));
+	}
+	return i;
+}
+
+#define RLNC_KERNEL_SCALAR	0
+#define RLNC_KERNEL_SSSE3	1
+#define RLNC_KERNEL_AVX2	2
+
+static int getKernel() {
+	static int kernel = -1;
+	if (kernel == -1) {
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2")) {
+			kernel = RLNC_KERNEL_AVX2;
+		} else if (__builtin_cpu_supports("ssse3")) {
+			kernel = RLNC_KERNEL_SSSE3;
+		} else {
+			kernel = RLNC_KERNEL_SCALAR;
+		}
+	}
+	return kernel;
+}
+
+#endif
+
+void Gf256::mulAdd(uint8_t* dst, const uint8_t* src, uint8_t c, size_t n) {
+	if (c == 0) {
+		return;
+	}
+	size_t done = 0;
+#ifdef RLNC_X86
+	if (!initialized) {
+		init();
+	}
+	int kernel = getKernel();
+	if (kernel == RLNC_KERNEL_AVX2) {
+		done = mulAddAvx2(dst, src, c, n);
+	}
+	if (kernel >= RLNC_KERNEL_SSSE3) {
+		done += mulAddSsse3(dst + done, src + done, c, n - done);
+	}
+#endif
+	if (done < n) {
+		// the tail, too short for a vector
+		for (size_t i = done; i < n; ++i) {
+			dst[i] ^= mul(c, src[i]);
+		}
+	}
+}
+
+const char* Gf256::getKernelName() {
+#ifdef RLNC_X86
+	int kernel = getKernel();
+	if (kernel == RLNC_KERNEL_AVX2) {
+		return "avx2";
+	} else if (kernel == RLNC_KERNEL_SSSE3) {
+		return "ssse3";
+	}
+#endif
+	return "scalar";
+}
+
+void writeRlncHeader(uint8_t* buf, RlncHeader& header) {
+	buf[0] = header.generation >> 24;
+	buf[1] = header.generation >> 16;
+	buf[2] = header.generation >> 8;
+	buf[3] = header.generation;
+	buf[4] = header.index;
+	buf[5] = header.k;
+	buf[6] = header.n;
+	buf[7] = header.flags;
+}
+
+bool readRlncHeader(const uint8_t* buf, size_t size, RlncHeader& header) {
+	if (size < RLNC_HEADER_SIZE) {
+		return false;
+	}
+	header.generation = (uint32_t) buf[0] << 24 | (uint32_t) buf[1] << 16 | (uint32_t) buf[2] << 8 | buf[3];
+	header.index = buf[4];
+	header.k = buf[5];
+	header.n = buf[6];
+	header.flags = buf[7];
+	return header.k > 0 && header.index < header.n && size >= (size_t) RLNC_HEADER_SIZE + header.k;
+}
+
+RlncEncoder::RlncEncoder(uint32_t k, size_t symbolSize) : k(k), symbolSize(symbolSize) {
+	sources.reserve(k);
+}
+
+bool RlncEncoder::addSource(const uint8_t* payload) {
+	if (sources.size() < k) {
+		sources.push_back(vector<uint8_t>(payload, payload + symbolSize));
+	}
+	return sources.size() == k;
+}
+
+void RlncEncoder::encodeRepair(const uint8_t* coefs, uint8_t* payload_out) {
+	memset(payload_out, 0, symbolSize);
+	for (uint32_t i = 0; i < sources.size(); ++i) {
+		Gf256::mulAdd(payload_out, sources[i].data(), coefs[i], symbolSize);
+	}
+}
+
+void RlncEncoder::reset() {
+	sources.clear();
+}
+
+uint32_t RlncEncoder::countSources() {
+	return sources.size();
+}
+
+RlncDecoder::RlncDecoder(uint32_t k, size_t symbolSize) : k(k), symbolSize(symbolSize), rank(0),
+		coefs(k), payloads(k), decoded(k, false) {
+}
+
+vector<uint32_t> RlncDecoder::addSymbol(const uint8_t* coefs_in, const uint8_t* payload_in) {
+	vector<uint32_t> indices_decoded;
+	if (rank == k) {
+		return indices_decoded;
+	}
+	vector<uint8_t> c(coefs_in, coefs_in + k);
+	vector<uint8_t> p(payload_in, payload_in + symbolSize);
+
+	// reduce the symbol by the basis, as every pivot is 1 and alone in its column
+	for (uint32_t j = 0; j < k; ++j) {
+		if (c[j] != 0 && coefs[j].size() > 0) {
+			uint8_t f = c[j];
+			Gf256::mulAdd(c.data(), coefs[j].data(), f, k);
+			Gf256::mulAdd(p.data(), payloads[j].data(), f, symbolSize);
+		}
+	}
+	uint32_t q = 0;
+	while (q < k && c[q] == 0) {
+		++q;
+	}
+	if (q == k) {
+		// linearly dependent on what has arrived
+		return indices_decoded;
+	}
+	uint8_t f_inv = Gf256::inv(c[q]);
+	Gf256::scale(c.data(), f_inv, k);
+	Gf256::scale(p.data(), f_inv, symbolSize);
+
+	// clear the new pivot column from the other rows
+	for (uint32_t r = 0; r < k; ++r) {
+		if (coefs[r].size() > 0 && coefs[r][q] != 0) {
+			uint8_t f = coefs[r][q];
+			Gf256::mulAdd(coefs[r].data(), c.data(), f, k);
+			Gf256::mulAdd(payloads[r].data(), p.data(), f, symbolSize);
+		}
+	}
+	coefs[q].swap(c);
+	payloads[q].swap(p);
+	++rank;
+
+	for (uint32_t r = 0; r < k; ++r) {
+		if (decoded[r] || coefs[r].size() == 0) {
+			continue;
+		}
+		bool isUnit = true;
+		for (uint32_t j = 0; j < k && isUnit; ++j) {
+			isUnit = j == r || coefs[r][j] == 0;
+		}
+		if (isUnit) {
+			decoded[r] = true;
+			indices_decoded.push_back(r);
+		}
+	}
+	return indices_decoded;
+}
+
+const uint8_t* RlncDecoder::getSource(uint32_t index) {
+	return index < k && decoded[index] ? payloads[index].data() : NULL;
+}
+
+uint32_t RlncDecoder::getRank() {
+	return rank;
+}
+
+bool RlncDecoder::isComplete() {
+	return rank == k;
+}
@@ -0,0 +1,96 @@
+/*
+ * This work is licensed under CC BY-NC-SA 4.0
+ * (https://creativecommons.org/licenses/by-nc-sa/4.0/).
+ * Copyright (c) 2025 Boyang Zhou
+ *
+ * This file is a part of "Subpath-Aware Reliable Transport Control Protocol (SART) for Wireless Multihop Networks"
+ * (https://github.com/zhouby-zjl/sart/).
+ * Written by Boyang Zhou (zhouby@zhejianglab.com / zby_zju@163.com)
+ *
+ */
+
+#ifndef SRC_NDNSIM_MODEL_RNTP_CODING_HPP_
+#define SRC_NDNSIM_MODEL_RNTP_CODING_HPP_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+using namespace std;
+
+// Layout of a coded capsule's content: the header, the k coding coefficients (a unit vector for
+// a source capsule), then the payload.
+#define RLNC_HEADER_SIZE				8
+#define RLNC_FLAG_REPAIR				0x01
+#define RLNC_MAX_PENDING_GENERATIONS	16
+
+struct RlncHeader {
+	uint32_t generation;
+	uint8_t  index;   // of the capsule in its generation, sources first
+	uint8_t  k;       // sources per generation
+	uint8_t  n;       // capsules per generation, sources and repairs
+	uint8_t  flags;
+};
+
+// GF(2^8) over the polynomial x^8 + x^4 + x^3 + x^2 + 1. The multiply-accumulate over a region
+// runs on AVX2 or SSSE3 when the CPU has them, picked at runtime, and falls back to tables.
+class Gf256 {
+public:
+	static uint8_t mul(uint8_t a, uint8_t b);
+	static uint8_t inv(uint8_t a);
+	// dst[i] ^= c * src[i]
+	static void mulAdd(uint8_t* dst, const uint8_t* src, uint8_t c, size_t n);
+	static void mulAddScalar(uint8_t* dst, const uint8_t* src, uint8_t c, size_t n);
+	// dst[i] = c * dst[i]
+	static void scale(uint8_t* dst, uint8_t c, size_t n);
+	static const char* getKernelName();
+
+private:
+	static void init();
+
+	static bool 	initialized;
+	static uint8_t 	expTable[512];
+	static uint8_t 	logTable[256];
+};
+
+void writeRlncHeader(uint8_t* buf, RlncHeader& header);
+bool readRlncHeader(const uint8_t* buf, size_t size, RlncHeader& header);
+
+// Collects the sources of one generation and combines them into repair symbols.
+class RlncEncoder {
+public:
+	RlncEncoder(uint32_t k, size_t symbolSize);
+	// returns true once the generation is full
+	bool addSource(const uint8_t* payload);
+	void encodeRepair(const uint8_t* coefs, uint8_t* payload_out);
+	void reset();
+	uint32_t countSources();
+
+private:
+	uint32_t 					k;
+	size_t 						symbolSize;
+	vector<vector<uint8_t> > 	sources;
+};
+
+// Decodes one generation progressively: every symbol is eliminated into a reduced row echelon
+// basis as it arrives, and a source is out as soon as its row is a unit vector, without waiting
+// for the generation to reach full rank.
+class RlncDecoder {
+public:
+	RlncDecoder(uint32_t k, size_t symbolSize);
+	// returns the indices of the sources the symbol makes decodable
+	vector<uint32_t> addSymbol(const uint8_t* coefs, const uint8_t* payload);
+	const uint8_t* getSource(uint32_t index);
+	uint32_t getRank();
+	bool isComplete();
+
+private:
+	uint32_t 					k;
+	size_t 						symbolSize;
+	uint32_t 					rank;
+	vector<vector<uint8_t> > 	coefs;      // indexed by pivot column, empty without a pivot
+	vector<vector<uint8_t> > 	payloads;
+	vector<bool> 				decoded;
+};
+
+#endif /* SRC_NDNSIM_MODEL_RNTP_CODING_HPP_ */
@@ -11,11 +11,14 @@
 
 #include "rntp-config.hpp"
 #include <fstream>
+#include <iostream>
 #include <regex>
 #include <stdlib.h>
 
 using namespace std;
 
+#define ECHO_MAX_PERIOD_MARGIN_IN_SECS		0.05
+
 string	 RntpConfig::LOG_DIR = "/tmp/";
 string   RntpConfig::STANDARD = "802.11a";
 string   RntpConfig::DATA_MODE = "OfdmRate54Mbps";
@@ -35,25 +38,76 @@ double   RntpConfig::NOISE_STOP_SEC = 15.0;
 double 	 RntpConfig::NOISE_MEAN = 10.0;
 double	 RntpConfig::NOISE_VAR = 5.0;
 double   RntpConfig::SIM_TIME_IN_SECS = 20;
+double	 RntpConfig::MEMORY_SAMPLE_PERIOD_IN_SECS = 0;
 double	 RntpConfig::EXTENSION_TIME_IN_SECS = 10;
 double	 RntpConfig::CAPSULE_PER_HOP_TIMEOUT = 1.0;
 uint32_t RntpConfig::CAPSULE_RETRYING_TIMES = 3;
 uint32_t RntpConfig::CONGESTION_CONTROL_THRESHOLD = 16;
 uint32_t RntpConfig::CONGESTION_CONTROL_INIT_WIN = 1;
-uint32_t RntpConfig::THROUGHPUT_QUEUE_SIZE_IN_SECS = 2;
-double   RntpConfig::PIAT_ESTIMATION_CONFIDENT_RATIO = 0.9999;
+string	 RntpConfig::CONGESTION_CONTROL = "aimd";
+uint32_t RntpConfig::TEST_TIMES_TO_IDENTIFY_LINK_AWAKEN = 3;
+double	 RntpConfig::PERIOD_IN_SECS_TO_IDENTIFY_LINK_AWAKEN = 3.5;
+uint32_t RntpConfig::LIVENESS_WINDOW_SIZE = 64;
+double   RntpConfig::LIVENESS_PHI_THRESHOLD = 8.0;
+double   RntpConfig::LIVENESS_MIN_STD_DEV_IN_SECS = 0.005;
+double   RntpConfig::LIVENESS_MIN_SILENCE_IN_SECS = 3.1;
+bool	 RntpConfig::ECHO_TRICKLE_ENABLED = false;
+double	 RntpConfig::ECHO_MAX_PERIOD_IN_SECS = 1.5;
+bool	 RntpConfig::DUTY_CYCLE_ENABLED = false;
+double	 RntpConfig::DUTY_CYCLE_PERIOD_IN_SECS = 1.0;
+double	 RntpConfig::DUTY_CYCLE_AWAKE_IN_SECS = 0.1;
+bool	 RntpConfig::INTEREST_SUPPRESSION_ENABLED = false;
+uint32_t RntpConfig::INTEREST_SUPPRESSION_COPIES = 2;
+uint32_t RntpConfig::INTEREST_SUPPRESSION_DEGREE = 8;
+uint32_t RntpConfig::DISCOVERY_HOP_SLACK = 2;
+double	 RntpConfig::DISCOVERY_MIN_QUALITY = 0.0;
 uint32_t RntpConfig::INTEREST_SEND_TIMES = 3;
 double	 RntpConfig::ECHO_PERIOD_IN_SECS = 1.0;
 double	 RntpConfig::MSG_TIMEOUT_IN_SECS = 3.5;
 double	 RntpConfig::INTEREST_CONTENTION_TIME_IN_SECS = 0.005;
 double   RntpConfig::CONSUMER_MAX_WAIT_TIME_IN_SECS = 5.0;
 double	 RntpConfig::QUALITY_ALPHA = 1.0 / 8.0;
+string	 RntpConfig::LINK_ESTIMATOR = "snr";
+uint32_t RntpConfig::ROUTE_MAX_PER_PAIR = 8;
+uint32_t RntpConfig::ROUTE_TABLE_MAX_ROUTES = 1024;
+double	 RntpConfig::ROUTE_IDLE_TIMEOUT_IN_SECS = 60.0;
+double	 RntpConfig::ROUTE_STALE_TIMEOUT_IN_SECS = 120.0;
+double	 RntpConfig::ROUTE_AGING_PERIOD_IN_SECS = 1.0;
+double	 RntpConfig::ROUTE_METRIC_QUALITY_WEIGHT = 1.0;
+double	 RntpConfig::ROUTE_METRIC_HOP_WEIGHT = 0.0;
+double	 RntpConfig::ROUTE_METRIC_QUEUE_WEIGHT = 0.0;
+double	 RntpConfig::ROUTE_METRIC_ENERGY_WEIGHT = 0.0;
+uint32_t RntpConfig::ROUTE_METRIC_QUEUE_CAPACITY = 64;
+double	 RntpConfig::TIMER_WHEEL_TICK_IN_SECS = 0.001;
+bool	 RntpConfig::STRIPING_ENABLED = false;
+uint32_t RntpConfig::STRIPING_MAX_PATHS = 3;
+uint32_t RntpConfig::STRIPING_MAX_REORDER = 16;
+double	 RntpConfig::STRIPING_DELIVERY_ALPHA = 0.125;
+bool	 RntpConfig::PACING_ENABLED = false;
+double	 RntpConfig::PACING_PHY_RATE_IN_MBPS = 6.0;
+double	 RntpConfig::PACING_FRAME_OVERHEAD_IN_SECS = 0.0002;
+uint32_t RntpConfig::PACING_HOPS_SHARING_CHANNEL = 3;
+double	 RntpConfig::PACING_GAIN = 1.25;
+bool	 RntpConfig::OPPORTUNISTIC_FORWARDING_ENABLED = false;
+double	 RntpConfig::OPPORTUNISTIC_FORWARDING_SLOT_IN_SECS = 0.002;
+bool	 RntpConfig::ADAPTIVE_RTO_ENABLED = false;
+double	 RntpConfig::RTO_MIN_IN_SECS = 0.01;
+double	 RntpConfig::RTO_MAX_IN_SECS = 1.0;
+bool	 RntpConfig::CODING_ENABLED = false;
+uint32_t RntpConfig::CODING_GENERATION_SIZE = 8;
+uint32_t RntpConfig::CODING_REPAIRS_PER_GENERATION = 2;
+bool	 RntpConfig::CAPSULE_REPAIR_ENABLED = false;
+double	 RntpConfig::CAPSULE_REPAIR_DELAY_IN_SECS = 0.5;
+uint32_t RntpConfig::CAPSULE_REPAIR_TIMES = 3;
+uint32_t RntpConfig::CACHE_MAX_SIZE_IN_PACKETS = 1000;
+uint32_t RntpConfig::DATA_ID_WINDOW_SIZE = 4096;
 uint32_t RntpConfig::PRODUCER_FREQ = 10;
 bool	 RntpConfig::CONSUMER_NEED_TO_TERMINATE_TRANSPORT = false;
 double	 RntpConfig::CONSUMER_TERMINATE_TRANSPORT_DELAY_IN_SECS = 100;
 double   RntpConfig::ENEGERY_BATTERY_CAPACITY_IN_MAH = 3000;
 double   RntpConfig::ENEGERY_BATTERY_VOLTAGE_IN_V = 1.5;
 bool	 RntpConfig::TRACE_BATTERY = false;
+bool	 RntpConfig::LOG_CAPSULE_QUEUE = false;
 
 std::vector<std::pair<std::string, std::string>> RntpConfig::standardModes = {
 		{"802.11a", "OfdmRate6Mbps"},
@@ -184,16 +238,42 @@ bool RntpConfig::loadConfigFile(string filePath) {
 				NOISE_START_SEC = atof(value.c_str());
 			} else if (name.compare("NOISE_STOP_SEC") == 0) {
 				NOISE_STOP_SEC = atof(value.c_str());
-			} else if (name.compare("THROUGHPUT_QUEUE_SIZE_IN_SECS") == 0) {
-				THROUGHPUT_QUEUE_SIZE_IN_SECS = atoi(value.c_str());
-			} else if (name.compare("PIAT_ESTIMATION_CONFIDENT_RATIO") == 0) {
-				PIAT_ESTIMATION_CONFIDENT_RATIO = atof(value.c_str());
+			} else if (name.compare("LIVENESS_WINDOW_SIZE") == 0) {
+				LIVENESS_WINDOW_SIZE = atoi(value.c_str());
+			} else if (name.compare("LIVENESS_PHI_THRESHOLD") == 0) {
+				LIVENESS_PHI_THRESHOLD = atof(value.c_str());
+			} else if (name.compare("LIVENESS_MIN_STD_DEV_IN_SECS") == 0) {
+				LIVENESS_MIN_STD_DEV_IN_SECS = atof(value.c_str());
+			} else if (name.compare("LIVENESS_MIN_SILENCE_IN_SECS") == 0) {
+				LIVENESS_MIN_SILENCE_IN_SECS = atof(value.c_str());
+			} else if (name.compare("ECHO_TRICKLE_ENABLED") == 0) {
+				ECHO_TRICKLE_ENABLED = (value.compare("true") == 0);
+			} else if (name.compare("ECHO_MAX_PERIOD_IN_SECS") == 0) {
+				ECHO_MAX_PERIOD_IN_SECS = atof(value.c_str());
+			} else if (name.compare("DUTY_CYCLE_ENABLED") == 0) {
+				DUTY_CYCLE_ENABLED = (value.compare("true") == 0);
+			} else if (name.compare("DUTY_CYCLE_PERIOD_IN_SECS") == 0) {
+				DUTY_CYCLE_PERIOD_IN_SECS = atof(value.c_str());
+			} else if (name.compare("DUTY_CYCLE_AWAKE_IN_SECS") == 0) {
+				DUTY_CYCLE_AWAKE_IN_SECS = atof(value.c_str());
+			} else if (name.compare("INTEREST_SUPPRESSION_ENABLED") == 0) {
+				INTEREST_SUPPRESSION_ENABLED = (value.compare("true") == 0);
+			} else if (name.compare("INTEREST_SUPPRESSION_COPIES") == 0) {
+				INTEREST_SUPPRESSION_COPIES = atoi(value.c_str());
+			} else if (name.compare("INTEREST_SUPPRESSION_DEGREE") == 0) {
+				INTEREST_SUPPRESSION_DEGREE = atoi(value.c_str());
+			} else if (name.compare("DISCOVERY_HOP_SLACK") == 0) {
+				DISCOVERY_HOP_SLACK = atoi(value.c_str());
+			} else if (name.compare("DISCOVERY_MIN_QUALITY") == 0) {
+				DISCOVERY_MIN_QUALITY = atof(value.c_str());
 			} else if (name.compare("NOISE_MEAN") == 0) {
 				NOISE_MEAN = atof(value.c_str());
 			} else if (name.compare("NOISE_VAR") == 0) {
 				NOISE_VAR = atof(value.c_str());
 			} else if (name.compare("SIM_TIME_IN_SECS") == 0) {
 				SIM_TIME_IN_SECS = atof(value.c_str());
+			} else if (name.compare("MEMORY_SAMPLE_PERIOD_IN_SECS") == 0) {
+				MEMORY_SAMPLE_PERIOD_IN_SECS = atof(value.c_str());
 			} else if (name.compare("EXTENSION_TIME_IN_SECS") == 0) {
 				EXTENSION_TIME_IN_SECS = atof(value.c_str());
 			} else if (name.compare("CAPSULE_PER_HOP_TIMEOUT") == 0) {
@@ -206,6 +286,12 @@ bool RntpConfig::loadConfigFile(string filePath) {
 				INTEREST_SEND_TIMES = atoi(value.c_str());
 			} else if (name.compare("CONGESTION_CONTROL_INIT_WIN") == 0) {
 				CONGESTION_CONTROL_INIT_WIN = atoi(value.c_str());
+			} else if (name.compare("CONGESTION_CONTROL") == 0) {
+				CONGESTION_CONTROL = value.c_str();
+			} else if (name.compare("TEST_TIMES_TO_IDENTIFY_LINK_AWAKEN") == 0) {
+				TEST_TIMES_TO_IDENTIFY_LINK_AWAKEN = atoi(value.c_str());
+			} else if (name.compare("PERIOD_IN_SECS_TO_IDENTIFY_LINK_AWAKEN") == 0) {
+				PERIOD_IN_SECS_TO_IDENTIFY_LINK_AWAKEN = atof(value.c_str());
 			} else if (name.compare("ECHO_PERIOD_IN_SECS") == 0) {
 				ECHO_PERIOD_IN_SECS = atof(value.c_str());
 			} else if (name.compare("MSG_TIMEOUT_IN_SECS") == 0) {
@@ -214,8 +300,76 @@ bool RntpConfig::loadConfigFile(string filePath) {
 				INTEREST_CONTENTION_TIME_IN_SECS = atof(value.c_str());
 			} else if (name.compare("QUALITY_ALPHA") == 0) {
 				QUALITY_ALPHA = atof(value.c_str());
+			} else if (name.compare("LINK_ESTIMATOR") == 0) {
+				LINK_ESTIMATOR = value.c_str();
+			} else if (name.compare("ROUTE_MAX_PER_PAIR") == 0) {
+				ROUTE_MAX_PER_PAIR = atoi(value.c_str());
+			} else if (name.compare("ROUTE_TABLE_MAX_ROUTES") == 0) {
+				ROUTE_TABLE_MAX_ROUTES = atoi(value.c_str());
+			} else if (name.compare("ROUTE_IDLE_TIMEOUT_IN_SECS") == 0) {
+				ROUTE_IDLE_TIMEOUT_IN_SECS = atof(value.c_str());
+			} else if (name.compare("ROUTE_STALE_TIMEOUT_IN_SECS") == 0) {
+				ROUTE_STALE_TIMEOUT_IN_SECS = atof(value.c_str());
+			} else if (name.compare("ROUTE_AGING_PERIOD_IN_SECS") == 0) {
+				ROUTE_AGING_PERIOD_IN_SECS = atof(value.c_str());
+			} else if (name.compare("ROUTE_METRIC_QUALITY_WEIGHT") == 0) {
+				ROUTE_METRIC_QUALITY_WEIGHT = atof(value.c_str());
+			} else if (name.compare("ROUTE_METRIC_HOP_WEIGHT") == 0) {
+				ROUTE_METRIC_HOP_WEIGHT = atof(value.c_str());
+			} else if (name.compare("ROUTE_METRIC_QUEUE_WEIGHT") == 0) {
+				ROUTE_METRIC_QUEUE_WEIGHT = atof(value.c_str());
+			} else if (name.compare("ROUTE_METRIC_ENERGY_WEIGHT") == 0) {
+				ROUTE_METRIC_ENERGY_WEIGHT = atof(value.c_str());
+			} else if (name.compare("ROUTE_METRIC_QUEUE_CAPACITY") == 0) {
+				ROUTE_METRIC_QUEUE_CAPACITY = atoi(value.c_str());
+			} else if (name.compare("TIMER_WHEEL_TICK_IN_SECS") == 0) {
+				TIMER_WHEEL_TICK_IN_SECS = atof(value.c_str());
+			} else if (name.compare("STRIPING_ENABLED") == 0) {
+				STRIPING_ENABLED = (value.compare("true") == 0);
+			} else if (name.compare("STRIPING_MAX_PATHS") == 0) {
+				STRIPING_MAX_PATHS = atoi(value.c_str());
+			} else if (name.compare("STRIPING_MAX_REORDER") == 0) {
+				STRIPING_MAX_REORDER = atoi(value.c_str());
+			} else if (name.compare("STRIPING_DELIVERY_ALPHA") == 0) {
+				STRIPING_DELIVERY_ALPHA = atof(value.c_str());
+			} else if (name.compare("PACING_ENABLED") == 0) {
+				PACING_ENABLED = (value.compare("true") == 0);
+			} else if (name.compare("PACING_PHY_RATE_IN_MBPS") == 0) {
+				PACING_PHY_RATE_IN_MBPS = atof(value.c_str());
+			} else if (name.compare("PACING_FRAME_OVERHEAD_IN_SECS") == 0) {
+				PACING_FRAME_OVERHEAD_IN_SECS = atof(value.c_str());
+			} else if (name.compare("PACING_HOPS_SHARING_CHANNEL") == 0) {
+				PACING_HOPS_SHARING_CHANNEL = atoi(value.c_str());
+			} else if (name.compare("PACING_GAIN") == 0) {
+				PACING_GAIN = atof(value.c_str());
+			} else if (name.compare("OPPORTUNISTIC_FORWARDING_ENABLED") == 0) {
+				OPPORTUNISTIC_FORWARDING_ENABLED = (value.compare("true") == 0);
+			} else if (name.compare("OPPORTUNISTIC_FORWARDING_SLOT_IN_SECS") == 0) {
+				OPPORTUNISTIC_FORWARDING_SLOT_IN_SECS = atof(value.c_str());
+			} else if (name.compare("ADAPTIVE_RTO_ENABLED") == 0) {
+				ADAPTIVE_RTO_ENABLED = (value.compare("true") == 0);
+			} else if (name.compare("RTO_MIN_IN_SECS") == 0) {
+				RTO_MIN_IN_SECS = atof(value.c_str());
+			} else if (name.compare("RTO_MAX_IN_SECS") == 0) {
+				RTO_MAX_IN_SECS = atof(value.c_str());
+			} else if (name.compare("CODING_ENABLED") == 0) {
+				CODING_ENABLED = (value.compare("true") == 0);
+			} else if (name.compare("CODING_GENERATION_SIZE") == 0) {
+				CODING_GENERATION_SIZE = atoi(value.c_str());
+			} else if (name.compare("CODING_REPAIRS_PER_GENERATION") == 0) {
+				CODING_REPAIRS_PER_GENERATION = atoi(value.c_str());
+			} else if (name.compare("CAPSULE_REPAIR_ENABLED") == 0) {
+				CAPSULE_REPAIR_ENABLED = (value.compare("true") == 0);
+			} else if (name.compare("CAPSULE_REPAIR_DELAY_IN_SECS") == 0) {
+				CAPSULE_REPAIR_DELAY_IN_SECS = atof(value.c_str());
+			} else if (name.compare("CAPSULE_REPAIR_TIMES") == 0) {
+				CAPSULE_REPAIR_TIMES = atoi(value.c_str());
 			} else if (name.compare("CONSUMER_MAX_WAIT_TIME_IN_SECS") == 0) {
 				CONSUMER_MAX_WAIT_TIME_IN_SECS = atof(value.c_str());
+			} else if (name.compare("CACHE_MAX_SIZE_IN_PACKETS") == 0) {
+				CACHE_MAX_SIZE_IN_PACKETS = atoi(value.c_str());
+			} else if (name.compare("DATA_ID_WINDOW_SIZE") == 0) {
+				DATA_ID_WINDOW_SIZE = atoi(value.c_str());
 			} else if (name.compare("PRODUCER_FREQ") == 0) {
 				PRODUCER_FREQ = atoi(value.c_str());
 			} else if (name.compare("ENEGERY_BATTERY_CAPACITY_IN_MAH") == 0) {
@@ -224,6 +378,8 @@ bool RntpConfig::loadConfigFile(string filePath) {
 				ENEGERY_BATTERY_VOLTAGE_IN_V = atof(value.c_str());
 			} else if (name.compare("TRACE_BATTERY") == 0) {
 				TRACE_BATTERY = (value.compare("true") == 0);
+			} else if (name.compare("LOG_CAPSULE_QUEUE") == 0) {
+				LOG_CAPSULE_QUEUE = (value.compare("true") == 0);
 			} else if (name.compare("CONSUMER_NEED_TO_TERMINATE_TRANSPORT") == 0) {
 				CONSUMER_NEED_TO_TERMINATE_TRANSPORT = (value.compare("true") == 0);
 			} else if (name.compare("CONSUMER_TERMINATE_TRANSPORT_DELAY_IN_SECS") == 0) {
@@ -232,5 +388,14 @@ bool RntpConfig::loadConfigFile(string filePath) {
 		}
 	}
 
+	// a single Echo lost on an idle link must leave a silence below MSG_TIMEOUT, with some room for
+	// the delays of the two Echoes around it, or the link is broken and the Trickle interval reset
+	double echoMaxPeriod_cap = MSG_TIMEOUT_IN_SECS / 2 - ECHO_MAX_PERIOD_MARGIN_IN_SECS;
+	if (ECHO_MAX_PERIOD_IN_SECS > echoMaxPeriod_cap) {
+		cerr << "ECHO_MAX_PERIOD_IN_SECS=" << ECHO_MAX_PERIOD_IN_SECS << " lets a lost Echo break an idle link under " <<
+				"MSG_TIMEOUT_IN_SECS=" << MSG_TIMEOUT_IN_SECS << ", lowered to " << echoMaxPeriod_cap << endl;
+		ECHO_MAX_PERIOD_IN_SECS = echoMaxPeriod_cap;
+	}
+
 	return true;
 }
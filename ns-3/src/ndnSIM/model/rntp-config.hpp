@@ -49,15 +49,31 @@ public:
 	static double	NOISE_VAR;
 
 	static double	SIM_TIME_IN_SECS;
+	static double	MEMORY_SAMPLE_PERIOD_IN_SECS;
 	static double	EXTENSION_TIME_IN_SECS;
 
 	static double	CAPSULE_PER_HOP_TIMEOUT;
 	static uint32_t	CAPSULE_RETRYING_TIMES;
 	static uint32_t CONGESTION_CONTROL_THRESHOLD;
 	static uint32_t CONGESTION_CONTROL_INIT_WIN;
-
-	static uint32_t THROUGHPUT_QUEUE_SIZE_IN_SECS;
-	static double   PIAT_ESTIMATION_CONFIDENT_RATIO;
+	static string	CONGESTION_CONTROL;
+	static uint32_t TEST_TIMES_TO_IDENTIFY_LINK_AWAKEN;
+	static double	PERIOD_IN_SECS_TO_IDENTIFY_LINK_AWAKEN;
+
+	static uint32_t LIVENESS_WINDOW_SIZE;
+	static double   LIVENESS_PHI_THRESHOLD;
+	static double   LIVENESS_MIN_STD_DEV_IN_SECS;
+	static double   LIVENESS_MIN_SILENCE_IN_SECS;
+	static bool		ECHO_TRICKLE_ENABLED;
+	static double	ECHO_MAX_PERIOD_IN_SECS;
+	static bool		DUTY_CYCLE_ENABLED;
+	static double	DUTY_CYCLE_PERIOD_IN_SECS;
+	static double	DUTY_CYCLE_AWAKE_IN_SECS;
+	static bool		INTEREST_SUPPRESSION_ENABLED;
+	static uint32_t INTEREST_SUPPRESSION_COPIES;
+	static uint32_t INTEREST_SUPPRESSION_DEGREE;
+	static uint32_t DISCOVERY_HOP_SLACK;
+	static double	DISCOVERY_MIN_QUALITY;
 
 	static uint32_t INTEREST_SEND_TIMES;
 
@@ -66,10 +82,44 @@ public:
 	static double	MSG_TIMEOUT_IN_SECS;
 	static double	INTEREST_CONTENTION_TIME_IN_SECS;
 	static double	QUALITY_ALPHA;
+	static string	LINK_ESTIMATOR;
+
+	static uint32_t ROUTE_MAX_PER_PAIR;
+	static uint32_t ROUTE_TABLE_MAX_ROUTES;
+	static double	ROUTE_IDLE_TIMEOUT_IN_SECS;
+	static double	ROUTE_STALE_TIMEOUT_IN_SECS;
+	static double	ROUTE_AGING_PERIOD_IN_SECS;
+	static double	ROUTE_METRIC_QUALITY_WEIGHT;
+	static double	ROUTE_METRIC_HOP_WEIGHT;
+	static double	ROUTE_METRIC_QUEUE_WEIGHT;
+	static double	ROUTE_METRIC_ENERGY_WEIGHT;
+	static uint32_t ROUTE_METRIC_QUEUE_CAPACITY;
+	static double	TIMER_WHEEL_TICK_IN_SECS;
+	static bool		STRIPING_ENABLED;
+	static uint32_t STRIPING_MAX_PATHS;
+	static uint32_t STRIPING_MAX_REORDER;
+	static double	STRIPING_DELIVERY_ALPHA;
+	static bool		PACING_ENABLED;
+	static double	PACING_PHY_RATE_IN_MBPS;
+	static double	PACING_FRAME_OVERHEAD_IN_SECS;
+	static uint32_t PACING_HOPS_SHARING_CHANNEL;
+	static double	PACING_GAIN;
+	static bool		OPPORTUNISTIC_FORWARDING_ENABLED;
+	static double	OPPORTUNISTIC_FORWARDING_SLOT_IN_SECS;
+	static bool		ADAPTIVE_RTO_ENABLED;
+	static double	RTO_MIN_IN_SECS;
+	static double	RTO_MAX_IN_SECS;
+	static bool		CODING_ENABLED;
+	static uint32_t CODING_GENERATION_SIZE;
+	static uint32_t CODING_REPAIRS_PER_GENERATION;
+	static bool		CAPSULE_REPAIR_ENABLED;
+	static double	CAPSULE_REPAIR_DELAY_IN_SECS;
+	static uint32_t CAPSULE_REPAIR_TIMES;
 
 	static double   CONSUMER_MAX_WAIT_TIME_IN_SECS;
 
 	static uint32_t CACHE_MAX_SIZE_IN_PACKETS;
+	static uint32_t DATA_ID_WINDOW_SIZE;
 	static uint32_t PRODUCER_FREQ;
 	static bool		CONSUMER_NEED_TO_TERMINATE_TRANSPORT;
 	static double	CONSUMER_TERMINATE_TRANSPORT_DELAY_IN_SECS;
@@ -78,6 +128,7 @@ public:
 	static double  ENEGERY_BATTERY_VOLTAGE_IN_V;
 
 	static bool	   TRACE_BATTERY;
+	static bool	   LOG_CAPSULE_QUEUE;
 
 	static std::vector<std::pair<std::string, std::string>> standardModes;
 };